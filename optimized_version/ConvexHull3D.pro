@@ -1,5 +1,5 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++11 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -17,6 +17,7 @@ HEADERS += \
     geometry/line.h \
     geometry/plane.h \
     geometry/point.h \
+    geometry/predicates.h \
     geometry/segment.h \
     geometry/transformations.h \
     geometry/triangle.h \
@@ -30,6 +31,7 @@ SOURCES += \
     geometry/line.cpp \
     geometry/plane.cpp \
     geometry/point.tpp \
+    geometry/predicates.tpp \
     geometry/segment.tpp \
     geometry/transformations.cpp \
     geometry/triangle.tpp \
@@ -40,6 +42,7 @@ SOURCES += \
 #io
 HEADERS += \
     io/load_save_file.h \
+    io/mapped_point_file.h \
     io/serializable_object.h \
     io/serialize.h \
     io/serialize_eigen.h \
@@ -48,6 +51,7 @@ HEADERS += \
 
 SOURCES += \
     io/load_save_file.tpp \
+    io/mapped_point_file.tpp \
     io/serialize.tpp \
     io/serialize_eigen.tpp \
     io/serialize_qt.tpp \
@@ -66,6 +70,7 @@ HEADERS += \
     utilities/set.h \
     utilities/string.h \
     utilities/system.h \
+    utilities/thread_pool.h \
     utilities/timer.h \
     utilities/tokenizer.h \
     utilities/vector.h \
@@ -80,6 +85,7 @@ SOURCES += \
     utilities/set.tpp \
     utilities/string.tpp \
     utilities/system.tpp \
+    utilities/thread_pool.tpp \
     utilities/timer.tpp \
     utilities/tokenizer.tpp \
     utilities/vector.tpp \
@@ -122,10 +128,42 @@ SOURCES += \
 
 #Convex Hull
 HEADERS += \
-    convex_hull/convexhull.h
+    convex_hull/conflict_graph.h \
+    convex_hull/convexhull.h \
+    convex_hull/convexhull_builder.h \
+    convex_hull/convexhull_workspace.h \
+    convex_hull/convexhull_control.h \
+    convex_hull/convexhull_cache.h \
+    convex_hull/dcel_vertex_view.h \
+    convex_hull/dynamic_convexhull.h \
+    convex_hull/face_planes.h \
+    convex_hull/instrumentation.h \
+    convex_hull/strided_point_view.h
 
 SOURCES += \
-    convex_hull/convexhull.tpp
+    convex_hull/approximate_hull.tpp \
+    convex_hull/batch.tpp \
+    convex_hull/brio.tpp \
+    convex_hull/chan.tpp \
+    convex_hull/conflict_graph.tpp \
+    convex_hull/convexhull.tpp \
+    convex_hull/convexhull_builder.tpp \
+    convex_hull/convexhull_workspace.tpp \
+    convex_hull/convexhull_control.tpp \
+    convex_hull/convexhull_cache.tpp \
+    convex_hull/dcel_vertex_view.tpp \
+    convex_hull/dynamic_convexhull.tpp \
+    convex_hull/divide_and_conquer.tpp \
+    convex_hull/extreme_points_filter.tpp \
+    convex_hull/face_planes.tpp \
+    convex_hull/instrumentation.tpp \
+    convex_hull/integer_hull.tpp \
+    convex_hull/low_memory_incremental.tpp \
+    convex_hull/out_of_core.tpp \
+    convex_hull/parallel_quickhull.tpp \
+    convex_hull/quickhull.tpp \
+    convex_hull/strided_hull.tpp \
+    convex_hull/strided_point_view.tpp
 
 SOURCES += \
         main.cpp
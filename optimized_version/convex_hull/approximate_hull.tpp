@@ -0,0 +1,241 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <queue>
+#include <climits>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief The farthest point pid of the outside set of the face fid, at the given distance from
+ * the plane of the face. stamp identifies the face, since the Dcel reuses the ids.
+ */
+struct ApproximateHullCandidate {
+    double distance;
+    unsigned int fid;
+    unsigned int stamp;
+    unsigned int pid;
+
+    bool operator<(const ApproximateHullCandidate& other) const { return distance < other.distance; }
+};
+
+/**
+ * @brief Returns the distance between p and the segment ab.
+ */
+inline double pointSegmentDistance(const Pointd& p, const Pointd& a, const Pointd& b)
+{
+    Vec3 ab = b - a;
+    double t = ab.dot(p - a);
+    double l = ab.dot(ab);
+    t = l > 0 ? std::min(std::max(t / l, 0.0), 1.0) : 0;
+    return (p - (a + ab * t)).length();
+}
+
+/**
+ * @brief Returns the distance between p and the triangle of the face f.
+ */
+inline double pointFaceDistance(const Pointd& p, const Dcel::Face* f)
+{
+    const Dcel::HalfEdge* e = f->outerHalfEdge();
+    const Pointd& a = e->fromVertex()->coordinate();
+    const Pointd& b = e->toVertex()->coordinate();
+    const Pointd& c = e->next()->toVertex()->coordinate();
+    Vec3 n = (b - a).cross(c - a);
+    //the projection of p on the plane is inside the triangle if it is on the inner side of the three edges
+    if (n.dot((b - a).cross(p - a)) >= 0 && n.dot((c - b).cross(p - b)) >= 0 && n.dot((a - c).cross(p - c)) >= 0){
+        double l = n.length();
+        return l > 0 ? std::fabs(n.dot(p - a)) / l : (p - a).length();
+    }
+    return std::min(pointSegmentDistance(p, a, b), std::min(pointSegmentDistance(p, b, c), pointSegmentDistance(p, c, a)));
+}
+
+/**
+ * @brief The policy of quickHullLoop for the approximate hull: it tests the points as
+ * QuickHullPolicy, but every outside point is assigned to the new face whose plane it is
+ * farthest from, and its distance from the triangle of that face, which is not smaller than its
+ * distance from the hull, is kept as a bound.
+ *
+ * The faces are processed in a priority queue on the largest bound of their points: the exact
+ * distance from the hull of the top point is computed before inserting it, and the point is
+ * discarded if it is not farther than epsilon. The loop stops when all the bounds are not
+ * larger than epsilon, or when the hull has maxVertices vertices (if maxVertices is not 0).
+ */
+struct ApproximateQuickHullPolicy : public QuickHullPolicy<std::vector<Pointd> > {
+    ApproximateQuickHullPolicy(
+            Dcel& convexHull,
+            ConvexHullWorkspace& workspace,
+            const std::vector<Pointd>& points,
+            double epsilon,
+            unsigned int maxVertices) :
+        QuickHullPolicy<std::vector<Pointd> >(convexHull, workspace.cg, points),
+        workspace(workspace),
+        epsilon(epsilon),
+        maxVertices(maxVertices),
+        bounds(points.size(), 0),
+        exactAt(points.size(), UINT_MAX),
+        nInsertions(0),
+        discardedBound(0)
+    {
+    }
+
+    void addFaces(const std::vector<Dcel::Face*>& faces)
+    {
+        QuickHullPolicy<std::vector<Pointd> >::addFaces(faces);
+        normalLengths.clear();
+        for (const Dcel::Face* f : faces){
+            const Dcel::HalfEdge* e = f->outerHalfEdge();
+            const Pointd& a = e->fromVertex()->coordinate();
+            normalLengths.push_back((e->toVertex()->coordinate() - a).cross(e->next()->toVertex()->coordinate() - a).length());
+        }
+        nInsertions++;
+    }
+
+    //the new face whose plane the point is farthest from (the distance is inexact, the side is exact)
+    int outsideFace(const std::vector<Dcel::Face*>& faces, unsigned int pid)
+    {
+        if (bounds[pid] < 0)
+            return -1;
+        int best = -1;
+        double distance = 0;
+        for (unsigned int i = 0; i < faces.size(); i++){
+            if (isOutside(faces[i], pid)){
+                double d = planes.distance(faces[i]->id(), points[pid]) / normalLengths[i];
+                if (best < 0 || d > distance){
+                    best = i;
+                    distance = d;
+                }
+            }
+        }
+        if (best >= 0){
+            bounds[pid] = pointFaceDistance(points[pid], faces[best]);
+            exactAt[pid] = UINT_MAX;
+        }
+        return best;
+    }
+
+    //the point of the face with the largest bound
+    void pushFace(const Dcel::Face* f)
+    {
+        if (f->id() >= stamps.size())
+            stamps.resize(f->id() + 1, 0);
+        stamps[f->id()]++;
+        ApproximateHullCandidate c = {-1, f->id(), stamps[f->id()], 0};
+        for (unsigned int q : cg.faceConflicts(f->id())){
+            if (bounds[q] > c.distance){
+                c.distance = bounds[q];
+                c.pid = q;
+            }
+        }
+        if (c.distance >= 0)
+            queue.push(c);
+    }
+
+    bool nextPoint(Dcel::Face*& f, unsigned int& pid)
+    {
+        while (!queue.empty()){
+            ApproximateHullCandidate c = queue.top();
+            f = convexHull.face(c.fid);
+            //the face could have been deleted, or its id could have been reused
+            if (f == nullptr || stamps[c.fid] != c.stamp){
+                queue.pop();
+                continue;
+            }
+            if (c.distance <= epsilon || (maxVertices > 0 && convexHull.numberVertices() >= maxVertices))
+                return false;
+            queue.pop();
+            pid = c.pid;
+            if (exactAt[pid] == nInsertions)
+                return true;
+
+            /**
+             * La distanza dal triangolo può sovrastimare quella dall'inviluppo: si calcola
+             * quella esatta, che può solo diminuire con gli inserimenti successivi. Un punto
+             * scartato resta nell'outside set della sua faccia, finché questa non viene eliminata.
+             */
+            bounds[pid] = hullDistance(f, pid);
+            exactAt[pid] = nInsertions;
+            if (bounds[pid] <= epsilon){
+                discardedBound = std::max(discardedBound, bounds[pid]);
+                bounds[pid] = -1;
+            }
+            pushFace(f);
+        }
+        return false;
+    }
+
+    //the distance of the point from the hull, if it sees the face f: the nearest point of the
+    //hull lies on a face visible from the point
+    double hullDistance(Dcel::Face* f, unsigned int pid)
+    {
+        double d = pointFaceDistance(points[pid], f);
+        quickHullVisibleFaces(workspace, *this, f, pid);
+        for (const Dcel::Face* g : workspace.visibleFaces)
+            d = std::min(d, pointFaceDistance(points[pid], g));
+        return d;
+    }
+
+    //the maximum distance between a discarded point and the hull
+    double errorBound()
+    {
+        double bound = discardedBound;
+        for (Dcel::Face* f : convexHull.faceIterator()){
+            for (unsigned int q : cg.faceConflicts(f->id())){
+                //a point nearer than the bound to its own triangle cannot increase it
+                if (bounds[q] >= 0 && pointFaceDistance(points[q], f) > bound)
+                    bound = std::max(bound, hullDistance(f, q));
+            }
+        }
+        return bound;
+    }
+
+    ConvexHullWorkspace& workspace;
+    double epsilon;
+    unsigned int maxVertices;
+    //bound of the distance of every outside point from the hull (negative if the point has been
+    //discarded), and the number of insertions when it has been computed exactly (UINT_MAX if it
+    //is the distance from the triangle)
+    std::vector<double> bounds;
+    std::vector<unsigned int> exactAt;
+    unsigned int nInsertions;
+    double discardedBound;
+    //length of the normals of the faces of the last addFaces
+    std::vector<double> normalLengths;
+    std::vector<unsigned int> stamps;
+    std::priority_queue<ApproximateHullCandidate> queue;
+};
+
+/**
+ * @brief Approximate Quickhull: inserts in convexHull an approximation of the hull of points,
+ * whose vertices are a subset of the hull vertices, with quickHullLoop and an
+ * ApproximateQuickHullPolicy: all the points are within epsilon from the returned hull, unless
+ * the hull has maxVertices vertices (if maxVertices is not 0; at least the four vertices of
+ * the initial tetrahedron are inserted). The points left in the outside sets are discarded.
+ *
+ * @return the maximum distance between a discarded point and the returned hull, measured (up to
+ * rounding) on the triangles of the faces visible from the point, which contain its nearest
+ * point of the hull
+ */
+inline double approximateQuickHull(
+        Dcel& convexHull,
+        std::vector<Pointd>& points,
+        double epsilon,
+        unsigned int maxVertices,
+        ConvexHullControl* control)
+{
+    if (!insertInitialTet(convexHull, points))
+        return 0;
+    ConvexHullWorkspace workspace;
+    ApproximateQuickHullPolicy policy(convexHull, workspace, points, epsilon, maxVertices);
+    const unsigned int simplex[4] = {0, 1, 2, 3};
+    quickHullLoop(convexHull, workspace, policy, (unsigned int)points.size(), simplex, control);
+    return policy.errorBound();
+}
+
+} //namespace cg3::internal
+} //namespace cg3
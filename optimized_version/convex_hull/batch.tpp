@@ -0,0 +1,177 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <utilities/thread_pool.h>
+#include <utilities/timer.h>
+#include <mutex>
+
+namespace cg3 {
+
+namespace internal {
+
+/**
+ * @brief The memory used by a thread of convexHullBatch, which is reused for all the sets
+ * computed by the thread.
+ */
+struct BatchScratch {
+    BatchScratch();
+
+    std::vector<Pointd> points;
+    std::vector<unsigned int> indices; //the positions of points in the set
+    Dcel convexHull;
+    ConvexHullWorkspace workspace;
+    ConvexHullOptions options; //the options of the sets, which use workspace
+    std::unordered_map<Pointd, unsigned int> hullVertices;
+    std::unordered_map<unsigned int, unsigned int> vertexIndex;
+    unsigned long long nInputPoints;
+    unsigned long long nCulledPoints;
+};
+
+inline BatchScratch::BatchScratch() :
+    nInputPoints(0),
+    nCulledPoints(0)
+{
+}
+
+/**
+ * @brief Computes in result the hull of the range [first, end) on the calling thread, with
+ * computeConvexHull and the options (and the memory) of scratch.
+ * @return false if the computation has been cancelled (result is then empty)
+ */
+template <class ForwardIterator>
+bool batchHull(
+        HullResult& result,
+        ForwardIterator first,
+        ForwardIterator end,
+        BatchScratch& scratch)
+{
+    scratch.points.assign(first, end);
+    scratch.nInputPoints += scratch.points.size();
+    scratch.indices.resize(scratch.points.size());
+    for (unsigned int i = 0; i < scratch.indices.size(); i++)
+        scratch.indices[i] = i;
+    if (scratch.options.extremePointsFilter)
+        scratch.nCulledPoints += extremePointsFilter(scratch.points, &scratch.indices);
+
+    scratch.convexHull.clear();
+    if (!computeConvexHull(scratch.convexHull, scratch.points, scratch.options, (double*)nullptr, &scratch.indices))
+        return false;
+    if (!scratch.indices.empty())
+        fillIndexedHullResult(result, scratch.convexHull, scratch.options.facePlanes);
+    else
+        fillHullResult(result, scratch.convexHull, first, end, scratch.options.facePlanes, scratch.hullVertices, scratch.vertexIndex);
+    return true;
+}
+
+} //namespace cg3::internal
+
+inline ConvexHullBatchStatistics::ConvexHullBatchStatistics() :
+    nSets(0),
+    nInputPoints(0),
+    nCulledPoints(0),
+    seconds(0),
+    hullsPerSecond(0),
+    cancelled(false)
+{
+}
+
+/**
+ * @brief Computes the convex hulls of a container of point sets, in the compact HullResult form.
+ * @param[in] sets: a container of point sets with size() and operator[]; every set is any
+ * container of Pointd with begin() and end()
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull of every set, with indices that refer to the positions of the points in the set
+ */
+template <class InputContainer>
+std::vector<HullResult> convexHullBatch(const InputContainer& sets, const ConvexHullOptions& options, ConvexHullBatchStatistics* statistics)
+{
+    return convexHullBatch(sets.begin(), sets.end(), options, statistics);
+}
+
+/**
+ * @brief Computes the convex hulls of the range of point sets [firstSet, endSet), in the compact
+ * HullResult form.
+ *
+ * This is meant for many small sets (e.g. thousands of sets of hundreds of points): the sets
+ * are distributed among options.nThreads threads, and every hull is computed on a single
+ * thread as in convexHullResult, with the algorithm, the extreme points filter and the
+ * approximation (epsilon, maxVertices) of options. The parallel algorithms run with a single
+ * thread, since the parallelism is among the sets. Every thread keeps its points, Dcel and
+ * workspace (conflict graph and face planes of the randomized incremental algorithm) between
+ * the sets, hence after the first sets the hulls are computed almost without allocations.
+ * options.workspace is ignored.
+ *
+ * options.cancel and options.deadline are checked by every set: once the computation is
+ * stopped, the remaining sets are not computed and their results are empty.
+ * options.progress is called, from the worker threads but never concurrently, after every set
+ * with the number of sets computed and the number of sets.
+ *
+ * @param[in] firstSet: a random access iterator to the first set; every set is any container
+ * of Pointd with begin() and end()
+ * @param[in] endSet
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation,
+ * including the throughput in hulls per second
+ * @return the convex hull of every set, with indices that refer to the positions of the points in the set
+ */
+template <class RandomAccessIterator>
+std::vector<HullResult> convexHullBatch(
+        RandomAccessIterator firstSet,
+        RandomAccessIterator endSet,
+        const ConvexHullOptions& options,
+        ConvexHullBatchStatistics* statistics)
+{
+    Timer timer;
+    const unsigned int nSets = (unsigned int)(endSet - firstSet);
+    std::vector<HullResult> results(nSets);
+
+    ThreadPool pool(options.nThreads);
+    std::vector<internal::BatchScratch> scratches(pool.numberThreads());
+    for (internal::BatchScratch& scratch : scratches){
+        scratch.options = options;
+        scratch.options.nThreads = 1;
+        scratch.options.progress = nullptr;
+        scratch.options.workspace = &scratch.workspace;
+    }
+
+    std::atomic<bool> stopped(false);
+    std::mutex progressMutex;
+    unsigned long long nComputedSets = 0;
+    pool.parallelFor(0, nSets, [&](unsigned int i){
+        if (stopped)
+            return;
+        internal::BatchScratch& scratch = scratches[ThreadPool::currentThreadIndex()];
+        const auto& set = firstSet[i];
+        if (!internal::batchHull(results[i], set.begin(), set.end(), scratch)){
+            stopped = true;
+            return;
+        }
+        if (options.progress){
+            std::unique_lock<std::mutex> lock(progressMutex);
+            options.progress(++nComputedSets, nSets);
+        }
+    });
+    timer.stop();
+
+    if (statistics != nullptr){
+        statistics->nSets = nSets;
+        statistics->nInputPoints = 0;
+        statistics->nCulledPoints = 0;
+        for (const internal::BatchScratch& scratch : scratches){
+            statistics->nInputPoints += scratch.nInputPoints;
+            statistics->nCulledPoints += scratch.nCulledPoints;
+        }
+        statistics->seconds = timer.delay();
+        statistics->hullsPerSecond = statistics->seconds > 0 ? nSets / statistics->seconds : 0;
+        statistics->cancelled = stopped;
+    }
+    return results;
+}
+
+} //namespace cg3
@@ -0,0 +1,222 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <utilities/thread_pool.h>
+#include <memory>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Bits of every quantized coordinate used by the Hilbert index.
+ */
+static const unsigned int hilbertBits = 19;
+
+/**
+ * @brief Points with a smaller number of points are sorted with a single thread.
+ */
+static const unsigned int parallelSortThreshold = 1 << 16;
+
+/**
+ * @brief The key of a point in the BRIO order, and the position of the point.
+ */
+struct BrioItem {
+    unsigned long long key;
+    unsigned int index;
+};
+
+/**
+ * @brief Returns the index along the 3D Hilbert curve of the cell (x, y, z) of a grid of
+ * 2^hilbertBits cells per side (Skilling's algorithm: the coordinates are transformed into the
+ * transposed form of the index, whose bits are then interleaved).
+ */
+inline unsigned long long hilbertIndex(unsigned int x, unsigned int y, unsigned int z)
+{
+    unsigned int X[3] = {x, y, z};
+    const unsigned int M = 1u << (hilbertBits - 1);
+
+    //inverse undo
+    for (unsigned int Q = M; Q > 1; Q >>= 1){
+        unsigned int P = Q - 1;
+        for (unsigned int i = 0; i < 3; i++){
+            if (X[i] & Q)
+                X[0] ^= P;
+            else {
+                unsigned int t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    //Gray encode
+    X[1] ^= X[0];
+    X[2] ^= X[1];
+    unsigned int t = 0;
+    for (unsigned int Q = M; Q > 1; Q >>= 1){
+        if (X[2] & Q)
+            t ^= Q - 1;
+    }
+    for (unsigned int i = 0; i < 3; i++)
+        X[i] ^= t;
+
+    unsigned long long index = 0;
+    for (int b = hilbertBits - 1; b >= 0; b--){
+        for (unsigned int i = 0; i < 3; i++)
+            index = (index << 1) | ((X[i] >> b) & 1);
+    }
+    return index;
+}
+
+/**
+ * @brief Sorts items by key with a stable LSD radix sort on 11 bits digits. If pool is not
+ * nullptr, every pass is split among its threads: each thread counts the digits of its chunk,
+ * and then moves its items to the positions given by the prefix sums of all the counts.
+ */
+inline void radixSort(std::vector<BrioItem>& items, unsigned long long maxKey, ThreadPool* pool)
+{
+    const unsigned int digitBits = 11;
+    const unsigned int nDigits = 1u << digitBits;
+    const unsigned int n = (unsigned int)items.size();
+    const unsigned int nChunks = pool != nullptr ? pool->numberThreads() : 1;
+    const unsigned int chunkSize = (n + nChunks - 1) / nChunks;
+
+    std::vector<BrioItem> buffer(n);
+    std::vector<unsigned int> counts(nChunks * nDigits);
+    for (unsigned int shift = 0; shift < 64 && (maxKey >> shift) > 0; shift += digitBits){
+        auto countDigits = [&](unsigned int c){
+            unsigned int* count = counts.data() + c * nDigits;
+            std::fill(count, count + nDigits, 0);
+            for (unsigned int i = c * chunkSize; i < std::min(n, (c+1) * chunkSize); i++)
+                count[(items[i].key >> shift) & (nDigits - 1)]++;
+        };
+        auto moveItems = [&](unsigned int c){
+            unsigned int* position = counts.data() + c * nDigits;
+            for (unsigned int i = c * chunkSize; i < std::min(n, (c+1) * chunkSize); i++)
+                buffer[position[(items[i].key >> shift) & (nDigits - 1)]++] = items[i];
+        };
+
+        if (pool != nullptr)
+            pool->parallelFor(0, nChunks, countDigits);
+        else
+            countDigits(0);
+
+        //the items of a chunk with a digit follow the items of the previous chunks with the same digit
+        unsigned int sum = 0;
+        for (unsigned int d = 0; d < nDigits; d++){
+            for (unsigned int c = 0; c < nChunks; c++){
+                unsigned int count = counts[c * nDigits + d];
+                counts[c * nDigits + d] = sum;
+                sum += count;
+            }
+        }
+
+        if (pool != nullptr)
+            pool->parallelFor(0, nChunks, moveItems);
+        else
+            moveItems(0);
+        items.swap(buffer);
+    }
+}
+
+/**
+ * @brief Sorts points by round and, within every round, along a Hilbert curve: the round of
+ * the position i is the last r with roundBegin[r] <= i (roundBegin[0] must be 0).
+ *
+ * The keys are the Hilbert indices of the points, quantized in their bounding box, prefixed by
+ * the round: all the points are sorted with a single radix sort, using nThreads threads for
+ * large inputs (0: all the hardware threads). If indices is not nullptr, it is an array
+ * parallel to points, which is reordered in the same way.
+ */
+inline void roundHilbertOrder(std::vector<Pointd>& points, const std::vector<unsigned int>& roundBegin, unsigned int nThreads, std::vector<unsigned int>* indices = nullptr)
+{
+    const unsigned int n = (unsigned int)points.size();
+    if (n == 0)
+        return;
+
+    Pointd min = points[0], max = points[0];
+    for (const Pointd& p : points){
+        min = min.min(p);
+        max = max.max(p);
+    }
+    const double cells = (double)((1u << hilbertBits) - 1);
+    Vec3 scale = max - min;
+    for (unsigned int i = 0; i < 3; i++)
+        scale[i] = scale[i] > 0 ? cells / scale[i] : 0;
+
+    std::unique_ptr<ThreadPool> pool;
+    if (n >= parallelSortThreshold && nThreads != 1)
+        pool.reset(new ThreadPool(nThreads));
+
+    std::vector<BrioItem> items(n);
+    auto computeKey = [&](unsigned int i){
+        unsigned long long r = std::upper_bound(roundBegin.begin(), roundBegin.end(), i) - roundBegin.begin() - 1;
+        const Pointd& p = points[i];
+        unsigned long long h = hilbertIndex(
+                    (unsigned int)((p.x() - min.x()) * scale.x()),
+                    (unsigned int)((p.y() - min.y()) * scale.y()),
+                    (unsigned int)((p.z() - min.z()) * scale.z()));
+        items[i].key = (r << (3 * hilbertBits)) | h;
+        items[i].index = i;
+    };
+    if (pool)
+        pool->parallelFor(0, n, computeKey);
+    else {
+        for (unsigned int i = 0; i < n; i++)
+            computeKey(i);
+    }
+
+    unsigned long long maxKey = ((unsigned long long)roundBegin.size() << (3 * hilbertBits)) - 1;
+    radixSort(items, maxKey, pool.get());
+
+    std::vector<Pointd> sorted(n);
+    for (unsigned int i = 0; i < n; i++)
+        sorted[i] = points[items[i].index];
+    points.swap(sorted);
+    if (indices != nullptr){
+        std::vector<unsigned int> sortedIndices(n);
+        for (unsigned int i = 0; i < n; i++)
+            sortedIndices[i] = (*indices)[items[i].index];
+        indices->swap(sortedIndices);
+    }
+}
+
+/**
+ * @brief Reorders points in a biased randomized insertion order (BRIO, Amenta, Choi and Rote):
+ * the (already shuffled) points are split in rounds of doubling size, where the last round
+ * contains half of the points, the previous one a quarter, and so on; the rounds are inserted
+ * in order, and the points of every round are sorted along a Hilbert curve. The expected
+ * complexity of the randomized incremental algorithm is preserved, while consecutive insertions
+ * touch close faces and conflict lists. If indices is not nullptr, it is an array parallel to
+ * points, which is reordered in the same way.
+ */
+inline void brioOrder(std::vector<Pointd>& points, unsigned int nThreads, std::vector<unsigned int>* indices)
+{
+    const unsigned int n = (unsigned int)points.size();
+    const unsigned int minRoundSize = 64;
+    if (n <= minRoundSize)
+        return;
+
+    //round of every position: [n/2, n) is the last round, [n/4, n/2) the previous one, ...
+    std::vector<unsigned int> roundBegin;
+    for (unsigned int begin = n; begin > minRoundSize; begin /= 2)
+        roundBegin.push_back(begin / 2);
+    std::reverse(roundBegin.begin(), roundBegin.end());
+    roundBegin[0] = 0;
+    roundHilbertOrder(points, roundBegin, nThreads, indices);
+}
+
+/**
+ * @brief Sorts points along a Hilbert curve, in a single round (see roundHilbertOrder).
+ */
+inline void hilbertOrder(std::vector<Pointd>& points, unsigned int nThreads)
+{
+    roundHilbertOrder(points, std::vector<unsigned int>(1, 0), nThreads);
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,442 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <geometry/predicates.h>
+#include <cmath>
+#include <random>
+#include <unordered_set>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief The hull of a group of points in Chan's algorithm: its vertices, as indices of the
+ * candidate points, and the adjacent vertices of every vertex (positions in vertices, from
+ * adjacencyBegin[i] to adjacencyBegin[i+1]).
+ */
+struct ChanGroup {
+    std::vector<unsigned int> vertices;
+    std::vector<unsigned int> adjacencyBegin;
+    std::vector<unsigned int> adjacency;
+    unsigned int last; //tangent point of the last query, start of the next walk
+};
+
+/**
+ * @brief An edge u -> v of the hull whose twin has not been found yet: w is a point of the
+ * face of the edge which is not on the edge.
+ */
+struct ChanEdge {
+    unsigned int u;
+    unsigned int v;
+    Pointd w;
+};
+
+/**
+ * @brief Computes the hull of groupPoints (whose order is changed) and stores in group its
+ * vertices and edges. The vertices are added to the candidate points, which contain only
+ * once the points with the same coordinates.
+ */
+inline void chanGroup(
+        ChanGroup& group,
+        std::vector<Pointd>& groupPoints,
+        std::vector<Pointd>& candidates,
+        std::unordered_map<Pointd, unsigned int>& candidateIds)
+{
+    Dcel hull;
+    quickHull(hull, groupPoints);
+    if (hull.numberVertices() == 0)
+        insertFlatHull(hull, groupPoints);
+
+    std::unordered_map<unsigned int, unsigned int> position;
+    for (const Dcel::Vertex* v : hull.vertexIterator()){
+        position[v->id()] = (unsigned int)group.vertices.size();
+        auto it = candidateIds.insert(std::make_pair(v->coordinate(), (unsigned int)candidates.size()));
+        if (it.second)
+            candidates.push_back(v->coordinate());
+        group.vertices.push_back(it.first->second);
+    }
+
+    group.adjacencyBegin.push_back(0);
+    for (const Dcel::Vertex* v : hull.vertexIterator()){
+        if (hull.numberFaces() > 0){
+            for (const Dcel::HalfEdge* e : v->outgoingHalfEdgeIterator())
+                group.adjacency.push_back(position[e->toVertex()->id()]);
+        }
+        else {
+            //a segment or a single point: the vertices are all adjacent
+            for (unsigned int j = 0; j < group.vertices.size(); j++){
+                if (j != position[v->id()])
+                    group.adjacency.push_back(j);
+            }
+        }
+        group.adjacencyBegin.push_back((unsigned int)group.adjacency.size());
+    }
+    group.last = 0;
+}
+
+/**
+ * @brief Tangent query: returns the vertex p of the group such that no vertex of the group
+ * is outside the face (v, u, p), or -1 if all the vertices of the group lie on the line uv.
+ *
+ * The query walks on the hull of the group, from the result of the previous query, towards
+ * the adjacent vertices outside the face (v, u, p): every step rotates the plane around the
+ * line uv, and the walk stops at a vertex whose plane supports its star, hence (by convexity)
+ * the whole hull of the group. The line uv must not cross the interior of the group hull.
+ */
+inline int chanTangent(ChanGroup& group, const std::vector<Pointd>& candidates, const Pointd& u, const Pointd& v)
+{
+    unsigned int s = group.last;
+    if (areCollinear(u, v, candidates[group.vertices[s]])){
+        s = 0;
+        while (s < group.vertices.size() && areCollinear(u, v, candidates[group.vertices[s]]))
+            s++;
+        if (s == group.vertices.size())
+            return -1;
+    }
+
+    bool moved = true;
+    while (moved){
+        moved = false;
+        const Pointd& p = candidates[group.vertices[s]];
+        for (unsigned int k = group.adjacencyBegin[s]; k < group.adjacencyBegin[s+1] && !moved; k++){
+            unsigned int w = group.adjacency[k];
+            if (areCoplanar(v, u, p, candidates[group.vertices[w]]) < 0){
+                s = w;
+                moved = true;
+            }
+        }
+    }
+    group.last = s;
+    return (int)group.vertices[s];
+}
+
+/**
+ * @brief Gift wrapping step: finds the face of the hull beyond the edge u -> v, which is on the
+ * boundary of a supporting plane. Every group answers a tangent query, the best tangent point
+ * gives the plane of the face, and coplanar is filled with all the candidate points on that
+ * plane, found by visiting the coplanar vertices of the groups from their tangent points.
+ * @return the best tangent point, or -1 if all the points are on the line uv
+ */
+inline int chanWrap(
+        std::vector<ChanGroup>& groups,
+        const std::vector<Pointd>& candidates,
+        const Pointd& u,
+        const Pointd& v,
+        std::vector<unsigned int>& coplanar,
+        std::vector<unsigned int>& stack)
+{
+    int best = -1;
+    for (ChanGroup& group : groups){
+        int t = chanTangent(group, candidates, u, v);
+        if (t >= 0 && (best < 0 || areCoplanar(v, u, candidates[best], candidates[t]) < 0))
+            best = t;
+    }
+    coplanar.clear();
+    if (best < 0)
+        return -1;
+
+    const Pointd& p = candidates[best];
+    std::set<unsigned int> visited;
+    for (ChanGroup& group : groups){
+        if (areCollinear(u, v, candidates[group.vertices[group.last]]) ||
+                areCoplanar(v, u, p, candidates[group.vertices[group.last]]) != 0)
+            continue;
+        visited.clear();
+        visited.insert(group.last);
+        stack.push_back(group.last);
+        while (stack.size() > 0){
+            unsigned int s = stack.back();
+            stack.pop_back();
+            coplanar.push_back(group.vertices[s]);
+            for (unsigned int k = group.adjacencyBegin[s]; k < group.adjacencyBegin[s+1]; k++){
+                unsigned int w = group.adjacency[k];
+                if (visited.find(w) == visited.end() && areCoplanar(v, u, p, candidates[group.vertices[w]]) == 0){
+                    visited.insert(w);
+                    stack.push_back(w);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Computes the polygon of coplanar points (indices of candidates, which are sorted and
+ * made unique): its corners, counterclockwise seen from the side opposite to witness, which
+ * must not lie on the plane of the points. Andrew's monotone chain is computed on the
+ * projection of the points on a coordinate plane, with exact orientation tests.
+ */
+inline void chanPolygon(
+        std::vector<unsigned int>& polygon,
+        std::vector<unsigned int>& coplanar,
+        const std::vector<Pointd>& candidates,
+        const Pointd& witness)
+{
+    std::sort(coplanar.begin(), coplanar.end());
+    coplanar.erase(std::unique(coplanar.begin(), coplanar.end()), coplanar.end());
+    polygon.clear();
+    if (coplanar.size() < 3)
+        return;
+
+    //projection on the coordinate plane where the polygon has the largest area
+    const Pointd& p0 = candidates[coplanar[0]];
+    Vec3 normal(0, 0, 0);
+    for (unsigned int i = 1; i+1 < coplanar.size() && normal.dot(normal) == 0; i++)
+        normal = (candidates[coplanar[i]] - p0).cross(candidates[coplanar[i+1]] - p0);
+    unsigned int axis = 0;
+    if (std::fabs(normal.y()) > std::fabs(normal[axis])) axis = 1;
+    if (std::fabs(normal.z()) > std::fabs(normal[axis])) axis = 2;
+    const unsigned int x = (axis + 1) % 3, y = (axis + 2) % 3;
+    std::sort(coplanar.begin(), coplanar.end(), [&](unsigned int a, unsigned int b){
+        if (candidates[a][x] != candidates[b][x])
+            return candidates[a][x] < candidates[b][x];
+        return candidates[a][y] < candidates[b][y];
+    });
+
+    //the turn is positive if the triangle is counterclockwise seen from outside
+    auto turn = [&](unsigned int a, unsigned int b, unsigned int c){
+        return areCoplanar(candidates[a], candidates[b], candidates[c], witness);
+    };
+    polygon.resize(2 * coplanar.size());
+    unsigned int k = 0;
+    for (unsigned int i = 0; i < coplanar.size(); i++){
+        while (k >= 2 && turn(polygon[k-2], polygon[k-1], coplanar[i]) <= 0)
+            k--;
+        polygon[k++] = coplanar[i];
+    }
+    for (unsigned int i = (unsigned int)coplanar.size() - 1, t = k + 1; i > 0; i--){
+        while (k >= t && turn(polygon[k-2], polygon[k-1], coplanar[i-1]) <= 0)
+            k--;
+        polygon[k++] = coplanar[i-1];
+    }
+    polygon.resize(k - 1);
+    if (polygon.size() < 3)
+        polygon.clear();
+}
+
+/**
+ * @brief Gift wrapping on the hulls of the groups: the faces of the hull are found one at a
+ * time, starting from a face through the lexicographically smallest point, by wrapping the
+ * edges whose twin face has not been found yet. Every face is the whole (convex) polygon of the
+ * points on its plane, triangulated as a fan.
+ * @return false if the hull has more than maxVertices vertices (the computation is then
+ * interrupted), or if the wrapping has found inconsistent faces
+ */
+inline bool chanWrapping(
+        Dcel& convexHull,
+        std::vector<ChanGroup>& groups,
+        const std::vector<Pointd>& candidates,
+        unsigned long long maxVertices,
+        ConvexHullControl* control)
+{
+    const unsigned long long nCandidates = candidates.size();
+    unsigned int a = 0;
+    for (unsigned int i = 1; i < nCandidates; i++){
+        const Pointd& p = candidates[i];
+        const Pointd& q = candidates[a];
+        if (p.x() < q.x() || (p.x() == q.x() && (p.y() < q.y() || (p.y() == q.y() && p.z() < q.z()))))
+            a = i;
+    }
+
+    /**
+     * Faccia iniziale fittizia sul piano x = a.x, che è di supporto: i punti a1 e a2 non
+     * appartengono all'input, e le loro coordinate x sono esattamente uguali a quella di a.
+     */
+    const Pointd& pa = candidates[a];
+    Pointd a1(pa.x(), pa.y() + std::max(1.0, std::fabs(pa.y())), pa.z());
+    Pointd a2(pa.x(), pa.y(), pa.z() + std::max(1.0, std::fabs(pa.z())));
+    unsigned int inner = 0;
+    while (inner < nCandidates && candidates[inner].x() == pa.x())
+        inner++;
+    if (inner == nCandidates)
+        return true; //coplanar points: the hull is left empty
+    if (areCoplanar(pa, a1, a2, candidates[inner]) < 0)
+        std::swap(a1, a2);
+
+    std::vector<unsigned int> coplanar, polygon, stack, triangles;
+    std::vector<ChanEdge> frontier;
+    std::unordered_set<unsigned long long> edges;
+    std::vector<int> vertexIndex(nCandidates, -1);
+    unsigned int nVertices = 0;
+
+    auto edgeKey = [nCandidates](unsigned int u, unsigned int v){
+        return u * nCandidates + v;
+    };
+    auto addFace = [&](){
+        for (unsigned int i = 0; i < polygon.size(); i++){
+            unsigned int u = polygon[i], v = polygon[(i+1) % polygon.size()];
+            if (!edges.insert(edgeKey(u, v)).second)
+                return false;
+            if (edges.find(edgeKey(v, u)) == edges.end())
+                frontier.push_back(ChanEdge{u, v, candidates[polygon[(i+2) % polygon.size()]]});
+            if (vertexIndex[u] < 0)
+                vertexIndex[u] = (int)nVertices++;
+        }
+        for (unsigned int i = 1; i+1 < polygon.size(); i++){
+            triangles.push_back(polygon[0]);
+            triangles.push_back(polygon[i]);
+            triangles.push_back(polygon[i+1]);
+        }
+        return nVertices <= maxVertices;
+    };
+
+    //first face: the face through a, or a face through the edge ab
+    int b = chanWrap(groups, candidates, pa, a1, coplanar, stack);
+    if (b < 0 || areCoplanar(pa, a1, a2, candidates[b]) == 0)
+        return true; //coplanar points
+    coplanar.push_back(a);
+    bool isEdge = true;
+    for (unsigned int q : coplanar)
+        isEdge = isEdge && areCollinear(pa, candidates[b], candidates[q]);
+    if (isEdge){
+        for (unsigned int q : coplanar){
+            if ((candidates[q] - pa).dot(candidates[q] - pa) > (candidates[b] - pa).dot(candidates[b] - pa))
+                b = q;
+        }
+        int c = chanWrap(groups, candidates, pa, candidates[b], coplanar, stack);
+        if (c < 0 || areCoplanar(pa, candidates[b], a1, candidates[c]) == 0)
+            return areAllCoplanar(candidates);
+        coplanar.push_back(a);
+        coplanar.push_back(b);
+        chanPolygon(polygon, coplanar, candidates, a1);
+    }
+    else
+        chanPolygon(polygon, coplanar, candidates, a2);
+    if (polygon.size() < 3 || !addFace())
+        return false;
+
+    while (frontier.size() > 0){
+        ChanEdge e = frontier.back();
+        frontier.pop_back();
+        if (edges.find(edgeKey(e.v, e.u)) != edges.end())
+            continue;
+        if (control != nullptr && control->mustStop())
+            return true;
+
+        const Pointd& u = candidates[e.u];
+        const Pointd& v = candidates[e.v];
+        int p = chanWrap(groups, candidates, u, v, coplanar, stack);
+        if (p < 0 || areCoplanar(u, v, e.w, candidates[p]) == 0){
+            //the hull is flat (it is left empty) only if all the points are coplanar
+            triangles.clear();
+            return areAllCoplanar(candidates);
+        }
+        coplanar.push_back(e.u);
+        coplanar.push_back(e.v);
+        chanPolygon(polygon, coplanar, candidates, e.w);
+
+        //the new face must contain the twin of the wrapped edge
+        bool twin = false;
+        for (unsigned int i = 0; i < polygon.size() && !twin; i++)
+            twin = polygon[i] == e.v && polygon[(i+1) % polygon.size()] == e.u;
+        if (!twin || !addFace())
+            return false;
+    }
+
+    std::vector<Dcel::Vertex*> vertices(nVertices);
+    for (unsigned int i = 0; i < nCandidates; i++){
+        if (vertexIndex[i] >= 0)
+            vertices[vertexIndex[i]] = convexHull.addVertex(candidates[i]);
+    }
+    for (unsigned int& t : triangles)
+        t = vertexIndex[t];
+    insertTriangles(convexHull, vertices, triangles);
+    return true;
+}
+
+/**
+ * @brief Estimates the number of hull vertices of points, from the hulls of two random samples
+ * of different sizes: the number of hull vertices is assumed to grow as a power of the number
+ * of points (between constant and linear), whose exponent is given by the samples.
+ */
+inline double estimateHullSize(const std::vector<Pointd>& points)
+{
+    const unsigned int sampleSizes[2] = {1024, 8192};
+    if (points.size() <= sampleSizes[1])
+        return (double)points.size();
+
+    std::mt19937 generator(5489u);
+    std::uniform_int_distribution<size_t> distribution(0, points.size() - 1);
+    double hullSizes[2];
+    for (unsigned int s = 0; s < 2; s++){
+        std::vector<Pointd> sample(sampleSizes[s]);
+        for (Pointd& p : sample)
+            p = points[distribution(generator)];
+        Dcel hull;
+        quickHull(hull, sample);
+        hullSizes[s] = std::max(4u, hull.numberVertices());
+    }
+    double exponent = std::log(hullSizes[1] / hullSizes[0]) / std::log((double)sampleSizes[1] / sampleSizes[0]);
+    exponent = std::min(std::max(exponent, 0.0), 1.0);
+    return hullSizes[1] * std::pow((double)points.size() / sampleSizes[1], exponent);
+}
+
+/**
+ * @brief Returns true if Chan's algorithm is expected to be faster than the randomized
+ * incremental algorithm on points: there are many points, and the estimated number of hull
+ * vertices is small enough to split them in several groups (see chanConvexHull).
+ */
+inline bool isChanConvenient(const std::vector<Pointd>& points)
+{
+    return points.size() >= (1u << 16) && estimateHullSize(points) <= points.size() / 128.0;
+}
+
+/**
+ * @brief Chan's output sensitive algorithm: inserts in convexHull the hull of points.
+ *
+ * The points are split in groups of groupSize points, whose hulls are computed with
+ * Quickhull; then the hull is built by gift wrapping, where the point that gives the next
+ * face is the best among the tangent points of the groups, found by walking on their hulls.
+ * Only the hull vertices of the groups are kept. If the hull has more than groupSize
+ * vertices, the wrapping is interrupted and the computation is repeated with groups of
+ * groupSize^2 points, until the groups contain all the points (which are then processed by
+ * Quickhull).
+ *
+ * @param[in] groupSize: the initial size of the groups (0: 16 times the estimated number of
+ * hull vertices, but at least 1/32 of the points: the hulls of larger groups are computed
+ * faster by Quickhull, and the tangent queries are fewer)
+ */
+inline void chanConvexHull(Dcel& convexHull, std::vector<Pointd>& points, unsigned int groupSize, ConvexHullControl* control)
+{
+    const unsigned long long nPoints = points.size();
+    unsigned long long m = groupSize;
+    if (m == 0)
+        m = std::max((unsigned long long)std::max(16 * estimateHullSize(points), nPoints / 32.0), 4096ULL);
+    m = std::max(m, 64ULL);
+
+    std::vector<Pointd> groupPoints;
+    std::vector<Pointd> candidates;
+    std::unordered_map<Pointd, unsigned int> candidateIds;
+    std::vector<ChanGroup> groups;
+    for (;; m = m * m){
+        if (m >= nPoints){
+            quickHull(convexHull, points, control);
+            return;
+        }
+
+        candidates.clear();
+        candidateIds.clear();
+        groups.clear();
+        groups.reserve((nPoints + m - 1) / m);
+        for (unsigned long long first = 0; first < nPoints; first += m){
+            unsigned long long last = std::min(first + m, nPoints);
+            groupPoints.assign(points.begin() + first, points.begin() + last);
+            groups.push_back(ChanGroup());
+            chanGroup(groups.back(), groupPoints, candidates, candidateIds);
+            if (control != nullptr && control->poll((unsigned int)last))
+                return;
+        }
+
+        if (chanWrapping(convexHull, groups, candidates, m, control))
+            return;
+        convexHull.clear();
+    }
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,67 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_CONFLICT_GRAPH_H
+#define CG3_CONVEXHULL_CONFLICT_GRAPH_H
+
+#include <vector>
+#include <assert.h>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief The ConflictGraph class is the conflict graph used by the incremental convex hull.
+ *
+ * Unlike a generic BipartiteGraph, nodes are not looked up by value: a point is identified
+ * by its index in the (shuffled) input array, and a face by its id in the Dcel of the hull.
+ * Both sides are therefore stored in dense arrays, and every node keeps its adjacences in a
+ * compact std::vector<unsigned int>.
+ *
+ * Points are never removed from the conflict lists of the faces: a point is deleted only when
+ * it is inserted in the hull (or discarded because it is inside the hull), and at that moment
+ * all the faces in its conflict list are going to be deleted too.
+ */
+class ConflictGraph
+{
+public:
+    ConflictGraph();
+    ConflictGraph(unsigned int nPoints);
+
+    void reset(unsigned int nPoints);
+
+    void addFace(unsigned int fid);
+    void addArc(unsigned int pid, unsigned int fid);
+    void deletePoint(unsigned int pid);
+    void deleteFace(unsigned int fid);
+
+    unsigned int sizePoints() const;
+    unsigned int sizeConflictsPoint(unsigned int pid) const;
+    unsigned int sizeConflictsFace(unsigned int fid) const;
+    const std::vector<unsigned int>& pointConflicts(unsigned int pid) const;
+    const std::vector<unsigned int>& faceConflicts(unsigned int fid) const;
+
+    void faceConflictsUnion(
+            unsigned int fid1,
+            unsigned int fid2,
+            unsigned int excludedPid,
+            std::vector<unsigned int>& points);
+
+protected:
+    std::vector<std::vector<unsigned int> > conflictsP; //faces visible by each point
+    std::vector<std::vector<unsigned int> > conflictsF; //points that see each face
+
+    std::vector<unsigned int> marks; //used to compute the union of two conflict lists
+    unsigned int currentMark;
+};
+
+} //namespace cg3::internal
+} //namespace cg3
+
+#include "conflict_graph.tpp"
+
+#endif // CG3_CONVEXHULL_CONFLICT_GRAPH_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "conflict_graph.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief ConflictGraph::ConflictGraph
+ * Default constructor. It creates an empty conflict graph.
+ */
+inline ConflictGraph::ConflictGraph() :
+    currentMark(0)
+{
+}
+
+/**
+ * @brief ConflictGraph::ConflictGraph
+ * Creates a conflict graph with nPoints points and no faces.
+ * @param[in] nPoints
+ */
+inline ConflictGraph::ConflictGraph(unsigned int nPoints) :
+    currentMark(0)
+{
+    reset(nPoints);
+}
+
+/**
+ * @brief ConflictGraph::reset
+ * Removes all the faces and all the arcs, and sets the number of points to nPoints.
+ * The memory of the conflict lists is kept, so that a graph can be reused for another hull.
+ * @param[in] nPoints
+ */
+inline void ConflictGraph::reset(unsigned int nPoints)
+{
+    for (unsigned int pid = 0; pid < conflictsP.size() && pid < nPoints; pid++)
+        conflictsP[pid].clear();
+    conflictsP.resize(nPoints);
+    for (std::vector<unsigned int>& faceConflicts : conflictsF)
+        faceConflicts.clear();
+    marks.assign(nPoints, 0);
+    currentMark = 0;
+}
+
+/**
+ * @brief ConflictGraph::addFace
+ * Adds the face fid, with an empty conflict list. Since the Dcel reuses the ids of the
+ * deleted faces, the slot of a deleted face is reused.
+ * @param[in] fid: the id of the face in the Dcel
+ */
+inline void ConflictGraph::addFace(unsigned int fid)
+{
+    if (fid >= conflictsF.size())
+        conflictsF.resize(fid+1);
+    assert(conflictsF[fid].empty());
+}
+
+/**
+ * @brief ConflictGraph::addArc
+ * Creates an arc between the point pid and the face fid (pid sees fid).
+ * @param[in] pid
+ * @param[in] fid
+ */
+inline void ConflictGraph::addArc(unsigned int pid, unsigned int fid)
+{
+    assert(pid < conflictsP.size());
+    assert(fid < conflictsF.size());
+    conflictsP[pid].push_back(fid);
+    conflictsF[fid].push_back(pid);
+}
+
+/**
+ * @brief ConflictGraph::deletePoint
+ * Removes all the arcs of the point pid, and releases its memory.
+ * The point is not removed from the conflict lists of its faces: they must be deleted
+ * right after (see the class description).
+ * @param[in] pid
+ */
+inline void ConflictGraph::deletePoint(unsigned int pid)
+{
+    std::vector<unsigned int>().swap(conflictsP[pid]);
+}
+
+/**
+ * @brief ConflictGraph::deleteFace
+ * Removes the face fid and all its arcs from the graph.
+ * @param[in] fid
+ */
+inline void ConflictGraph::deleteFace(unsigned int fid)
+{
+    for (unsigned int pid : conflictsF[fid]){
+        std::vector<unsigned int>& faces = conflictsP[pid];
+        for (unsigned int i = 0; i < faces.size(); i++){
+            if (faces[i] == fid){
+                faces[i] = faces.back();
+                faces.pop_back();
+                break;
+            }
+        }
+    }
+    conflictsF[fid].clear();
+}
+
+/**
+ * @brief ConflictGraph::sizePoints
+ * @return the number of points of the graph
+ */
+inline unsigned int ConflictGraph::sizePoints() const
+{
+    return (unsigned int)conflictsP.size();
+}
+
+/**
+ * @brief ConflictGraph::sizeConflictsPoint
+ * @param[in] pid
+ * @return the number of faces visible by the point pid
+ */
+inline unsigned int ConflictGraph::sizeConflictsPoint(unsigned int pid) const
+{
+    return (unsigned int)conflictsP[pid].size();
+}
+
+/**
+ * @brief ConflictGraph::sizeConflictsFace
+ * @param[in] fid
+ * @return the number of points that see the face fid
+ */
+inline unsigned int ConflictGraph::sizeConflictsFace(unsigned int fid) const
+{
+    return (unsigned int)conflictsF[fid].size();
+}
+
+/**
+ * @brief ConflictGraph::pointConflicts
+ * @param[in] pid
+ * @return the ids of the faces visible by the point pid
+ */
+inline const std::vector<unsigned int>& ConflictGraph::pointConflicts(unsigned int pid) const
+{
+    return conflictsP[pid];
+}
+
+/**
+ * @brief ConflictGraph::faceConflicts
+ * @param[in] fid
+ * @return the indices of the points that see the face fid
+ */
+inline const std::vector<unsigned int>& ConflictGraph::faceConflicts(unsigned int fid) const
+{
+    return conflictsF[fid];
+}
+
+/**
+ * @brief ConflictGraph::faceConflictsUnion
+ * Computes the union of the conflict lists of the faces fid1 and fid2, without
+ * duplicates and without the point excludedPid.
+ * @param[in] fid1
+ * @param[in] fid2
+ * @param[in] excludedPid: a point that will not be inserted in the output
+ * @param[out] points: the union of the two conflict lists
+ */
+inline void ConflictGraph::faceConflictsUnion(
+        unsigned int fid1,
+        unsigned int fid2,
+        unsigned int excludedPid,
+        std::vector<unsigned int>& points)
+{
+    if (++currentMark == 0){
+        marks.assign(marks.size(), 0);
+        currentMark = 1;
+    }
+    marks[excludedPid] = currentMark;
+
+    points.clear();
+    points.reserve(conflictsF[fid1].size() + conflictsF[fid2].size());
+    for (unsigned int pid : conflictsF[fid1]){
+        if (marks[pid] != currentMark){
+            marks[pid] = currentMark;
+            points.push_back(pid);
+        }
+    }
+    for (unsigned int pid : conflictsF[fid2]){
+        if (marks[pid] != currentMark){
+            marks[pid] = currentMark;
+            points.push_back(pid);
+        }
+    }
+}
+
+} //namespace cg3::internal
+} //namespace cg3
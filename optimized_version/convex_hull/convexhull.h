@@ -10,21 +10,201 @@
 #define CG3_CONVEXHULL_H
 
 #include "dcel/dcel.h"
-#include "bipartite_graph/bipartite_graph.h"
+#include "conflict_graph.h"
+#include "face_planes.h"
+#include "convexhull_workspace.h"
+#include "convexhull_control.h"
+#include "strided_point_view.h"
+#include "dcel_vertex_view.h"
+#include <future>
 
 
 namespace cg3 {
 
-Dcel convexHull(const Dcel& inputDcel);
+typedef enum {
+    RANDOMIZED_INCREMENTAL,
+    QUICKHULL,
+    PARALLEL_DIVIDE_AND_CONQUER,
+    PARALLEL_QUICKHULL,
+    CHAN,
+    AUTOMATIC,
+    LOW_MEMORY_INCREMENTAL
+} ConvexHullAlgorithm;
+
+typedef enum {
+    RANDOM_ORDER,
+    BRIO_ORDER
+} ConvexHullInsertionOrder;
+
+/**
+ * @brief The options of the convexHull functions.
+ */
+struct ConvexHullOptions {
+    ConvexHullOptions(ConvexHullAlgorithm algorithm = RANDOMIZED_INCREMENTAL, unsigned int nThreads = 0);
+
+    ConvexHullAlgorithm algorithm; //algorithm used to compute the convex hull
+    unsigned int nThreads; //threads used by the parallel algorithms (0: all the hardware threads)
+    bool extremePointsFilter; //discards the points inside the hull of the extreme points
+    bool facePlanes; //computes the planes of the triangles (convexHullResult)
+    ConvexHullInsertionOrder insertionOrder; //order of insertion of the points (randomized incremental)
+    ConvexHullWorkspace* workspace; //memory reused by the randomized incremental algorithm (nullptr: a new one for every hull)
+    ConvexHullProgressCallback progress; //called periodically with the number of processed points (it can be empty)
+    std::chrono::steady_clock::time_point deadline; //the computation is cancelled after this time point (default: no deadline)
+    const std::atomic<bool>* cancel; //the computation is cancelled when the token becomes true (nullptr: no token)
+    double epsilon; //approximate hull: every input point is within epsilon from the returned hull (0: exact hull)
+    unsigned int maxVertices; //approximate hull: maximum number of vertices (0: exact hull)
+};
+
+/**
+ * @brief The statistics collected by the convexHull functions.
+ */
+struct ConvexHullStatistics {
+    ConvexHullStatistics();
+
+    unsigned long long nInputPoints;
+    unsigned long long nCulledPoints; //points discarded by the extreme points filter
+    unsigned long long bytesRead; //bytes read from the input file (convexHullOutOfCore)
+    unsigned long long peakMemory; //peak resident memory of the process (convexHullOutOfCore)
+    ConvexHullCounters counters; //counters of the randomized incremental algorithm (see CG3_CONVEXHULL_INSTRUMENTATION)
+    bool cancelled; //the computation was stopped by the cancellation token or by the deadline
+    double errorBound; //upper bound of the distance between the input points and the hull (approximate hull)
+};
+
+/**
+ * @brief The statistics collected by convexHullBatch.
+ */
+struct ConvexHullBatchStatistics {
+    ConvexHullBatchStatistics();
+
+    unsigned long long nSets;
+    unsigned long long nInputPoints; //total number of points of the sets
+    unsigned long long nCulledPoints; //points discarded by the extreme points filter
+    double seconds; //wall clock time of the computation
+    double hullsPerSecond;
+    bool cancelled; //the computation was stopped by the cancellation token or by the deadline
+};
+
+/**
+ * @brief The HullResult struct is a compact representation of a convex hull, computed by
+ * convexHullResult. All the indices refer to the positions of the points in the input of
+ * convexHullResult.
+ */
+struct HullResult {
+    std::vector<unsigned int> vertices; //the hull vertices
+    std::vector<unsigned int> triangles; //three vertices for every triangle, counterclockwise seen from outside
+    std::vector<double> planes; //(a, b, c, d) for every triangle: ax + by + cz + d = 0, (a, b, c) is the unit outward normal
+
+    unsigned int numberTriangles() const;
+
+    template <class InputContainer>
+    Dcel toDcel(const InputContainer& points) const;
+};
+
+Dcel convexHull(
+        const Dcel& inputDcel,
+        ConvexHullAlgorithm algorithm = RANDOMIZED_INCREMENTAL,
+        unsigned int nThreads = 0);
+
+Dcel convexHull(
+        const Dcel& inputDcel,
+        const ConvexHullOptions& options,
+        ConvexHullStatistics* statistics = nullptr);
 
 template <class InputContainer>
-Dcel convexHull(const InputContainer& points);
+Dcel convexHull(
+        const InputContainer& points,
+        ConvexHullAlgorithm algorithm = RANDOMIZED_INCREMENTAL,
+        unsigned int nThreads = 0);
+
+template <class InputContainer>
+Dcel convexHull(
+        const InputContainer& points,
+        const ConvexHullOptions& options,
+        ConvexHullStatistics* statistics = nullptr);
+
+template <class InputIterator>
+Dcel convexHull(
+        InputIterator first,
+        InputIterator end,
+        ConvexHullAlgorithm algorithm = RANDOMIZED_INCREMENTAL,
+        unsigned int nThreads = 0);
 
 template <class InputIterator>
-Dcel convexHull(InputIterator first, InputIterator end);
+Dcel convexHull(
+        InputIterator first,
+        InputIterator end,
+        const ConvexHullOptions& options,
+        ConvexHullStatistics* statistics = nullptr);
+
+template <class Scalar>
+Dcel convexHull(
+        const StridedPointView<Scalar>& points,
+        ConvexHullAlgorithm algorithm = RANDOMIZED_INCREMENTAL,
+        unsigned int nThreads = 0);
+
+template <class Scalar>
+Dcel convexHull(
+        const StridedPointView<Scalar>& points,
+        const ConvexHullOptions& options,
+        ConvexHullStatistics* statistics = nullptr);
+
+template <class InputContainer>
+std::future<Dcel> convexHullAsync(
+        const InputContainer& points,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullStatistics* statistics = nullptr);
+
+HullResult convexHullResult(
+        const Dcel& inputDcel,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullStatistics* statistics = nullptr);
+
+template <class InputContainer>
+HullResult convexHullResult(
+        const InputContainer& points,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullStatistics* statistics = nullptr);
+
+template <class ForwardIterator>
+HullResult convexHullResult(
+        ForwardIterator first,
+        ForwardIterator end,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullStatistics* statistics = nullptr);
+
+template <class InputContainer>
+std::vector<HullResult> convexHullBatch(
+        const InputContainer& sets,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullBatchStatistics* statistics = nullptr);
+
+template <class RandomAccessIterator>
+std::vector<HullResult> convexHullBatch(
+        RandomAccessIterator firstSet,
+        RandomAccessIterator endSet,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullBatchStatistics* statistics = nullptr);
+
+Dcel convexHullOutOfCore(
+        const std::string& filename,
+        unsigned long long memoryLimit,
+        const ConvexHullOptions& options = ConvexHullOptions(),
+        ConvexHullStatistics* statistics = nullptr);
 
 } //namespace cg3
 
 #include "convexhull.tpp"
+#include "quickhull.tpp"
+#include "divide_and_conquer.tpp"
+#include "parallel_quickhull.tpp"
+#include "extreme_points_filter.tpp"
+#include "out_of_core.tpp"
+#include "approximate_hull.tpp"
+#include "integer_hull.tpp"
+#include "strided_hull.tpp"
+#include "chan.tpp"
+#include "low_memory_incremental.tpp"
+#include "batch.tpp"
+#include "brio.tpp"
 
 #endif // CG3_CONVEXHULL_H
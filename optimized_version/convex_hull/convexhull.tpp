@@ -7,7 +7,13 @@
  */
 
 #include "convexhull.h"
-#include <Eigen/Dense>
+#include <geometry/predicates.h>
+#include <utilities/timer.h>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <unordered_map>
 
 namespace cg3 {
 
@@ -16,19 +22,116 @@ namespace cg3 {
 
 namespace internal {
 
+inline bool computeConvexHull(Dcel& convexHull, std::vector<Pointd>& points, const ConvexHullOptions& options, double* errorBound = nullptr, std::vector<unsigned int>* indices = nullptr);
+
+inline bool computeConvexHull(Dcel& convexHull, std::vector<Pointd>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics, std::vector<unsigned int>* indices = nullptr);
+
+inline Dcel convexHullDcel(std::vector<Pointd>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics);
+
+template <class InputIterator, class T>
+Dcel convexHullRange(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics, const T*);
+
+template <class InputIterator>
+Dcel convexHullRange(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics, const Pointi*);
+
+template <class InputIterator>
+Dcel convexHullRange(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics, const Pointf*);
+
+inline bool computeIntegerConvexHull(Dcel& convexHull, std::vector<Pointi>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics);
+
+template <class PointArray>
+bool computeStridedConvexHull(Dcel& convexHull, const PointArray& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics);
+
+inline void insertTriangles(Dcel& dcel, const std::vector<Dcel::Vertex*>& vertices, const std::vector<unsigned int>& triangles);
+
+inline void randomizedIncrementalConvexHull(Dcel& convexHull, std::vector<Pointd>& points);
+
+inline void randomizedIncrementalConvexHull(Dcel& convexHull, std::vector<Pointd>& points, ConvexHullWorkspace& workspace, ConvexHullInsertionOrder order = RANDOM_ORDER, unsigned int nThreads = 1, ConvexHullControl* control = nullptr, std::vector<unsigned int>* indices = nullptr);
+
+inline void shufflePoints(std::vector<Pointd>& points, std::vector<unsigned int>* indices, std::mt19937& rng);
+
+inline void brioOrder(std::vector<Pointd>& points, unsigned int nThreads, std::vector<unsigned int>* indices = nullptr);
+
+inline void hilbertOrder(std::vector<Pointd>& points, unsigned int nThreads);
+
+template <class ForwardIterator>
+void fillHullResult(
+        HullResult& result,
+        const Dcel& convexHull,
+        ForwardIterator first,
+        ForwardIterator end,
+        bool facePlanes,
+        std::unordered_map<Pointd, unsigned int>& hullVertices,
+        std::unordered_map<unsigned int, unsigned int>& vertexIndex);
+
+inline void fillIndexedHullResult(HullResult& result, const Dcel& convexHull, bool facePlanes);
+
+template <class VertexIndex>
+void fillHullTriangles(HullResult& result, const Dcel& convexHull, bool facePlanes, VertexIndex vertexIndex);
+
+inline void quickHull(Dcel& convexHull, std::vector<Pointd>& points, ConvexHullControl* control = nullptr, std::vector<unsigned int>* indices = nullptr);
+
+inline void parallelDivideAndConquerConvexHull(Dcel& convexHull, std::vector<Pointd>& points, unsigned int nThreads, ConvexHullControl* control = nullptr);
+
+inline void parallelQuickHull(Dcel& convexHull, std::vector<Pointd>& points, unsigned int nThreads, ConvexHullControl* control = nullptr);
+
+inline void chanConvexHull(Dcel& convexHull, std::vector<Pointd>& points, unsigned int groupSize = 0, ConvexHullControl* control = nullptr);
+
+inline bool isChanConvenient(const std::vector<Pointd>& points);
+
+inline void lowMemoryIncrementalConvexHull(Dcel& convexHull, std::vector<Pointd>& points, ConvexHullInsertionOrder order = RANDOM_ORDER, unsigned int nThreads = 1, ConvexHullControl* control = nullptr);
+
+inline double approximateQuickHull(Dcel& convexHull, std::vector<Pointd>& points, double epsilon, unsigned int maxVertices, ConvexHullControl* control = nullptr);
+
+inline unsigned int extremePointsFilter(std::vector<Pointd>& points, std::vector<unsigned int>* indices = nullptr);
+
 inline double areCoplanar(const Pointd &p0, const Pointd &p1, const Pointd &p2, const Pointd &p3);
 
 inline bool isFaceVisible(const Dcel::Face* f, const Pointd &p);
 
+inline bool isFaceStrictlyVisible(const Dcel::Face* f, const Pointd &p);
+
+inline bool areCollinear(const Pointd& a, const Pointd& b, const Pointd& c);
+
+inline bool isCollinearHorizonEdge(const Dcel::HalfEdge* he, const Pointd& p);
+
+template <class IsVisible, class AddVisible>
+void extendVisibleFaces(std::vector<Dcel::Face*>& stack, const Pointd& p, IsVisible isVisible, AddVisible addVisible);
+
+inline void addCoplanarFaces(ConvexHullWorkspace& workspace, const Pointd& p);
+
+inline bool insertPoint(Dcel& convexHull, ConvexHullWorkspace& workspace, const std::vector<Pointd>& points, unsigned int i);
+
+template <class PointArray>
+unsigned int findInitialSimplex(const PointArray& points, unsigned int simplex[4]);
+
+inline bool insertInitialTet(Dcel& dcel, std::vector<Pointd>& points, std::vector<unsigned int>* indices = nullptr);
+
+template <class PointArray>
+void insertFlatHull(Dcel& dcel, const PointArray& points);
+
 inline void insertTet(Dcel &dcel, const Pointd &p0, const Pointd &p1, const Pointd &p2, const Pointd &p3);
 
-inline void horizonEdgeList(std::vector<Dcel::HalfEdge*> &horizon, const std::set<Dcel::Face*>& visibleFaces, std::set<Dcel::Vertex*>& horizonVertex, const Pointd &next_point);
+inline void horizonEdgeList(std::vector<Dcel::HalfEdge*> &horizon, const std::set<Dcel::Face*>& visibleFaces, std::set<Dcel::Vertex*>& horizonVertex);
+
+inline void horizonEdgeList(ConvexHullWorkspace& workspace);
+
+inline void calculateP(ConvexHullWorkspace& workspace, unsigned int pid);
 
-inline void calculateP(std::vector<std::set<Pointd> >& P, const BipartiteGraph<Pointd, unsigned int>& cg, std::vector<Dcel::HalfEdge*> &horizonEdges);
+inline void deleteVisibleFaces(Dcel & ch, std::set<Dcel::Vertex*>& horizonVertices, const std::set<Dcel::Face*>& visibleFaces, ConflictGraph& cg);
 
-inline void deleteVisibleFaces(Dcel & ch, std::set<Dcel::Vertex*>& horizonVertices, const std::set<Dcel::Face*>& visibleFaces, BipartiteGraph<Pointd, unsigned int>& cg);
+inline void deleteVisibleFaces(Dcel& ch, ConvexHullWorkspace& workspace);
 
-inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*>& horizonEdges, const Pointd & p, BipartiteGraph<Pointd, unsigned int>& cg, std::vector<std::set<Pointd> > & P);
+inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*>& horizonEdges, const Pointd & p, std::vector<Dcel::Face*>& newFaces);
+
+inline Dcel::Vertex* newFacesApex(const std::vector<Dcel::Face*>& newFaces);
+
+inline void setFacePlane(FacePlanes& planes, const Dcel::Face* f);
+
+inline void initConflictGraph(ConvexHullWorkspace& workspace, const Dcel& convexHull, const std::vector<Pointd>& points, unsigned int begin);
+inline bool initLocatedConflictGraph(ConvexHullWorkspace& workspace, Dcel& convexHull, const std::vector<Pointd>& points, const std::vector<unsigned int>& located, unsigned long long maxArcs);
+
+inline void updateConflictGraph(ConvexHullWorkspace& workspace, const std::vector<Pointd>& points);
 
 } //namespace cg3::internal
 
@@ -36,163 +139,1169 @@ inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*>& horizonEdge
 
 /* ----- IMPLEMENTATION OF CONVEX HULL 3D ----- */
 
-inline Dcel convexHull(const Dcel& inputDcel)
+inline ConvexHullOptions::ConvexHullOptions(ConvexHullAlgorithm algorithm, unsigned int nThreads) :
+    algorithm(algorithm),
+    nThreads(nThreads),
+    extremePointsFilter(false),
+    facePlanes(false),
+    insertionOrder(RANDOM_ORDER),
+    workspace(nullptr),
+    deadline(std::chrono::steady_clock::time_point::max()),
+    cancel(nullptr),
+    epsilon(0),
+    maxVertices(0)
+{
+}
+
+inline ConvexHullStatistics::ConvexHullStatistics() :
+    nInputPoints(0),
+    nCulledPoints(0),
+    bytesRead(0),
+    peakMemory(0),
+    cancelled(false),
+    errorBound(0)
+{
+}
+
+/**
+ * @brief Computes the convex hull of the vertices of a Dcel.
+ * @param[in] inputDcel
+ * @param[in] algorithm: the algorithm used to compute the convex hull
+ * @param[in] nThreads: number of threads used by the parallel algorithms (0: all the hardware threads)
+ * @return the convex hull, a triangle mesh
+ */
+inline Dcel convexHull(const Dcel& inputDcel, ConvexHullAlgorithm algorithm, unsigned int nThreads)
+{
+    return convexHull(inputDcel, ConvexHullOptions(algorithm, nThreads));
+}
+
+/**
+ * @brief Computes the convex hull of the vertices of a Dcel. The coordinates of the vertices
+ * are copied: convexHullResult(inputDcel) reads them in place.
+ * @param[in] inputDcel
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, a triangle mesh
+ */
+inline Dcel convexHull(const Dcel& inputDcel, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
 {
     std::vector<Pointd> points;
     points.reserve(inputDcel.numberVertices());
     for (const Dcel::Vertex* v : inputDcel.vertexIterator()){
         points.push_back(v->coordinate());
     }
-    return convexHull(points.begin(), points.end());
+    return convexHull(points.begin(), points.end(), options, statistics);
 }
 
+/**
+ * @brief Computes the convex hull of a container of points.
+ * @param[in] container: any container of Pointd with begin() and end()
+ * @param[in] algorithm: the algorithm used to compute the convex hull
+ * @param[in] nThreads: number of threads used by the parallel algorithms (0: all the hardware threads)
+ * @return the convex hull, a triangle mesh
+ */
 template <class InputContainer>
-Dcel convexHull(const InputContainer& container)
+Dcel convexHull(const InputContainer& container, ConvexHullAlgorithm algorithm, unsigned int nThreads)
 {
-    return convexHull(container.begin(), container.end());
+    return convexHull(container.begin(), container.end(), ConvexHullOptions(algorithm, nThreads));
 }
 
+/**
+ * @brief Computes the convex hull of a container of points.
+ * @param[in] container: any container of Pointd with begin() and end()
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, a triangle mesh
+ */
+template <class InputContainer>
+Dcel convexHull(const InputContainer& container, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    return convexHull(container.begin(), container.end(), options, statistics);
+}
 
+/**
+ * @brief Computes the convex hull of the range of points [first, end).
+ * @param[in] first
+ * @param[in] end
+ * @param[in] algorithm: the algorithm used to compute the convex hull
+ * @param[in] nThreads: number of threads used by the parallel algorithms (0: all the hardware threads)
+ * @return the convex hull, a triangle mesh
+ */
 template <class InputIterator>
-Dcel convexHull(InputIterator first, InputIterator end)
+Dcel convexHull(InputIterator first, InputIterator end, ConvexHullAlgorithm algorithm, unsigned int nThreads)
+{
+    return convexHull(first, end, ConvexHullOptions(algorithm, nThreads));
+}
+
+/**
+ * @brief Computes the convex hull of the range of points [first, end).
+ *
+ * The same hull can be computed with different algorithms:
+ * - RANDOMIZED_INCREMENTAL: all the points are inserted in random order, and the conflicts
+ *   between every point and every face of the hull are kept in a conflict graph. With
+ *   options.insertionOrder = BRIO_ORDER the random order is biased: the points are inserted
+ *   in rounds, each sorted along a Hilbert curve, which improves the cache locality;
+ * - QUICKHULL: every face keeps only the points that are outside it (each point is
+ *   assigned to just one face), and only the farthest point of a face is inserted at
+ *   every step. Points that fall inside the hull are discarded as soon as they are found,
+ *   so this algorithm is faster when most of the points are inside the hull;
+ * - PARALLEL_DIVIDE_AND_CONQUER: the points are split by spatial median, the hulls of the
+ *   parts are computed in parallel by nThreads threads and then merged pairwise by wrapping
+ *   the band of faces which joins them (Preparata-Hong). With a single thread it is the
+ *   serial RANDOMIZED_INCREMENTAL;
+ * - PARALLEL_QUICKHULL: Quickhull where nThreads threads process at the same time the
+ *   outside sets of faces which are far from each other;
+ * - CHAN: Chan's output sensitive algorithm, O(n log h) for h hull vertices. The points are
+ *   split in groups, whose hulls are computed with Quickhull, and the hull is built by gift
+ *   wrapping around the hulls of the groups. It is faster when there are millions of points
+ *   but only a few hundreds of hull vertices;
+ * - AUTOMATIC: CHAN if the hulls of two random samples of the points suggest that the hull
+ *   is small, RANDOMIZED_INCREMENTAL otherwise;
+ * - LOW_MEMORY_INCREMENTAL: the points are inserted as in RANDOMIZED_INCREMENTAL (also in
+ *   BRIO order), but without conflict graph: every point is located by walking on the hull,
+ *   from the last face or from the face stored in a coarse grid. Besides the input, it uses
+ *   memory proportional only to the size of the hull (in BRIO order, the sort of the points
+ *   needs temporary memory proportional to their number).
+ *
+ * If options.extremePointsFilter is true, before the computation of the hull the points
+ * which are strictly inside the hull of the extreme points along 26 fixed directions are
+ * discarded (Akl-Toussaint heuristic). This takes a single pass over the points, and
+ * usually discards most of the points of dense inputs.
+ *
+ * The engines periodically call options.progress, and stop as soon as options.cancel becomes
+ * true or options.deadline is reached: in that case the returned hull is empty and
+ * statistics->cancelled is true. PARALLEL_DIVIDE_AND_CONQUER with more than one thread does not
+ * report the progress.
+ *
+ * If options.epsilon or options.maxVertices is not 0, an approximate hull is computed with a
+ * variant of Quickhull (whatever the algorithm of options) which inserts the farthest points
+ * first, and stops when all the points are within epsilon from the hull, or when the hull has
+ * maxVertices vertices. The vertices of the approximate hull are
+ * hull vertices, and statistics->errorBound is an upper bound of the distance between the
+ * input points and the approximate hull.
+ *
+ * If the points are Pointi, the hull is computed at compile time by an integer variant of
+ * Quickhull, whose orientation tests are exact determinants in 128 bit integers, without
+ * floating point filters: it is exact for all the int coordinates (the differences are below
+ * 2^32 and the determinants below 2^99), and the vertices of the hull have the same (exactly
+ * representable) coordinates. The algorithm, the extreme points filter and the approximation
+ * of options are ignored; progress, deadline and cancel are honored.
+ *
+ * If the points are Pointf, they are copied as floats (not converted to Pointd) and the hull is
+ * computed as for a StridedPointView of floats: to avoid also this copy, view them in place
+ * with a StridedPointView.
+ *
+ * @param[in] first
+ * @param[in] end
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, a triangle mesh
+ */
+template <class InputIterator>
+Dcel convexHull(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type PointType;
+    return internal::convexHullRange(first, end, options, statistics, (const PointType*)nullptr);
+}
+
+/**
+ * @brief Computes the convex hull of points read in place through a StridedPointView.
+ * @param[in] points
+ * @param[in] algorithm: ignored (see the other overload)
+ * @param[in] nThreads: ignored
+ * @return the convex hull, a triangle mesh
+ */
+template <class Scalar>
+Dcel convexHull(const StridedPointView<Scalar>& points, ConvexHullAlgorithm algorithm, unsigned int nThreads)
+{
+    return convexHull(points, ConvexHullOptions(algorithm, nThreads));
+}
+
+/**
+ * @brief Computes the convex hull of points read in place through a StridedPointView (e.g.
+ * float triplets, an interleaved vertex buffer or an array of Pointf), without copying them
+ * to Pointd.
+ *
+ * The hull is computed by a variant of Quickhull whose conflict graph refers to the positions
+ * of the points in the view, which are converted to Pointd only when they are tested. The
+ * orientation tests use the cached plane of every face with a static floating point filter,
+ * and the exact predicate only when the filter is uncertain: the result is exact. The
+ * algorithm, the extreme points filter and the approximation of options are ignored;
+ * progress, deadline and cancel are honored.
+ *
+ * @param[in] points
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, a triangle mesh
+ */
+template <class Scalar>
+Dcel convexHull(const StridedPointView<Scalar>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
 {
     Dcel convexHull;
-    BipartiteGraph<Pointd, unsigned int> cg;
+    internal::computeStridedConvexHull(convexHull, points, options, statistics);
+    convexHull.updateFaceNormals();
+    convexHull.updateVertexNormals();
+    convexHull.updateBoundingBox();
+    return convexHull;
+}
 
-    std::vector<Pointd> points(first, end);
-    std::random_shuffle(points.begin(), points.end());
+/**
+ * @brief Computes the convex hull of a container of points on a worker thread.
+ *
+ * The points are copied before the function returns, hence the container can be modified
+ * while the hull is computed; options are copied too, but the objects they point to (the
+ * workspace and the cancellation token) and statistics must outlive the computation.
+ * The computation can be stopped through options.cancel or options.deadline (see convexHull):
+ * the future then returns an empty Dcel.
+ *
+ * @param[in] container: any container of Pointd with begin() and end()
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the future convex hull, a triangle mesh
+ */
+template <class InputContainer>
+std::future<Dcel> convexHullAsync(const InputContainer& container, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    std::vector<Pointd> points(container.begin(), container.end());
+    return std::async(
+        std::launch::async,
+        [options, statistics](std::vector<Pointd> points){
+            return internal::convexHullDcel(points, options, statistics);
+        },
+        std::move(points));
+}
 
-    double determinant = 0;
-    unsigned int nPoints = (unsigned int)points.size();
-    int a, b, c, d;
-    do {
-        a = rand()%nPoints;
-        b = rand()%nPoints;
-        c = rand()%nPoints;
-        d = rand()%nPoints;
-
-        determinant = internal::areCoplanar(points[a], points[b], points[c], points[d]);
-    } while (determinant == 0);
-    std::swap(points[0], points[a]);
-    std::swap(points[1], points[b]);
-    std::swap(points[2], points[c]);
-    std::swap(points[3], points[d]);
-
-    if (determinant > 0)
-        internal::insertTet(convexHull, points[0], points[1], points[2], points[3]);
-    else
-        internal::insertTet(convexHull, points[1], points[0], points[2], points[3]);
+/**
+ * @brief Computes the convex hull of a container of points, in the compact HullResult form.
+ * @param[in] container: any container of Pointd with begin() and end()
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, with indices that refer to the positions of the points in container
+ */
+template <class InputContainer>
+HullResult convexHullResult(const InputContainer& container, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    return convexHullResult(container.begin(), container.end(), options, statistics);
+}
 
-    for (Dcel::Face* f : convexHull.faceIterator()){
-        cg.addRightNode(f->id());
+/**
+ * @brief Computes the convex hull of the range of points [first, end), in the compact
+ * HullResult form.
+ *
+ * The hull is computed as in convexHull, but it is returned as arrays of indices of the input
+ * points instead of a Dcel, and normals and bounding box are not computed. The randomized
+ * incremental and the Quickhull engines keep the index of the point of every hull vertex, which
+ * is copied in the result (the index of one of the occurrences of a repeated point). With the
+ * other engines, and if the points are coplanar, the hull vertices are found in the range,
+ * which is visited again (hence it must be a forward range) after the computation of the hull:
+ * the index of a hull vertex is then its first occurrence. If options.facePlanes is true, the
+ * planes of the triangles are computed too. The Dcel of the hull can be built by
+ * HullResult::toDcel.
+ *
+ * @param[in] first
+ * @param[in] end
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, with indices that refer to the positions of the points in [first, end)
+ */
+template <class ForwardIterator>
+HullResult convexHullResult(ForwardIterator first, ForwardIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    HullResult result;
+    Dcel convexHull;
+    std::vector<unsigned int> indices;
+    {
+        std::vector<Pointd> points(first, end);
+        internal::computeConvexHull(convexHull, points, options, statistics, &indices);
     }
 
+    if (!indices.empty()){
+        internal::fillIndexedHullResult(result, convexHull, options.facePlanes);
+        return result;
+    }
+    std::unordered_map<Pointd, unsigned int> hullVertices;
+    std::unordered_map<unsigned int, unsigned int> vertexIndex;
+    internal::fillHullResult(result, convexHull, first, end, options.facePlanes, hullVertices, vertexIndex);
+    return result;
+}
 
-    for (unsigned int i = 4; i < points.size(); i++){
-        cg.addLeftNode(points[i]);
-        for (Dcel::Face* f : convexHull.faceIterator()){
-            if (internal::isFaceVisible(f, points[i]))
-                cg.addArc(points[i], f->id());
+/**
+ * @brief Computes the convex hull of the vertices of a Dcel, in the compact HullResult form,
+ * reading the vertices in place: in NDEBUG builds the contiguous array of the vertex
+ * coordinates of the Dcel, otherwise the vertices themselves. No copy of the points is made.
+ *
+ * The hull is computed as the hull of a StridedPointView (the algorithm, the extreme points
+ * filter and the approximation of options are ignored). The unused ids of the Dcel (the ids
+ * of deleted vertices) are skipped. The indices of the result are the ids of the vertices of
+ * inputDcel: the index of a hull vertex is the smallest id of a vertex with its coordinates.
+ *
+ * @param[in] inputDcel
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * @return the convex hull, with indices that are ids of vertices of inputDcel
+ */
+inline HullResult convexHullResult(const Dcel& inputDcel, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    HullResult result;
+    Dcel convexHull;
+    internal::DcelVertexView points(inputDcel);
+    internal::computeStridedConvexHull(convexHull, points, options, statistics);
+    if (statistics != nullptr)
+        statistics->nInputPoints = inputDcel.numberVertices();
+
+    //the hull vertices are found among the used ids with a single pass
+    std::unordered_map<Pointd, unsigned int> hullVertices;
+    std::unordered_map<unsigned int, unsigned int> vertexIndex;
+    for (const Dcel::Vertex* v : convexHull.vertexIterator())
+        hullVertices[v->coordinate()] = v->id();
+    result.vertices.reserve(hullVertices.size());
+    for (unsigned int vid = 0; vid < points.size() && vertexIndex.size() < hullVertices.size(); vid++){
+        if (!points.isUsed(vid))
+            continue;
+        auto hv = hullVertices.find(points[vid]);
+        if (hv != hullVertices.end() && vertexIndex.find(hv->second) == vertexIndex.end()){
+            vertexIndex[hv->second] = vid;
+            result.vertices.push_back(vid);
         }
     }
+    internal::fillHullTriangles(result, convexHull, options.facePlanes, [&vertexIndex](const Dcel::Vertex* v){
+        return vertexIndex[v->id()];
+    });
+    return result;
+}
 
-    unsigned int iterations = 0;
-    while (cg.sizeLeftNodes() > 0){
-        for (const Pointd& p : cg.leftNodeIterator()){ //For every point that is not inserted in the convex hull yet
-            /**
-             * Se il punto è interno al convex hull, nel conflict graph il nodo associato al punto non
-             * ha archi uscenti: si ignora il punto.
-             */
-            if (cg.sizeAdjacencesLeftNode(p) > 0){
-
-                /**
-                 * Calcolo l'array (ordinato per face_id!) delle facce sul convex hull viste da next_point
-                 */
-                std::set<Dcel::Face*> visibleFaces;
-                for (const unsigned int& f : cg.adjacentLeftNodeIterator(p)){
-                    visibleFaces.insert(convexHull.face(f));
-                }
+/**
+ * @brief HullResult::numberTriangles
+ * @return the number of triangles of the hull
+ */
+inline unsigned int HullResult::numberTriangles() const
+{
+    return (unsigned int)triangles.size() / 3;
+}
+
+/**
+ * @brief HullResult::toDcel
+ * Builds the Dcel of the hull, with the same content returned by convexHull.
+ * @param[in] points: the input of convexHullResult, any container of Pointd with operator[]
+ * @return the convex hull, a triangle mesh
+ */
+template <class InputContainer>
+Dcel HullResult::toDcel(const InputContainer& points) const
+{
+    Dcel dcel;
+    std::unordered_map<unsigned int, unsigned int> localIndex;
+    std::vector<Dcel::Vertex*> dcelVertices(vertices.size());
+    for (unsigned int i = 0; i < vertices.size(); i++){
+        dcelVertices[i] = dcel.addVertex(points[vertices[i]]);
+        localIndex[vertices[i]] = i;
+    }
+    std::vector<unsigned int> localTriangles(triangles.size());
+    for (unsigned int i = 0; i < triangles.size(); i++)
+        localTriangles[i] = localIndex[triangles[i]];
+    internal::insertTriangles(dcel, dcelVertices, localTriangles);
 
-                std::set<Dcel::Vertex*> horizonVertex;
-                std::vector<Dcel::HalfEdge*> horizonEdges;
-
-                /**
-                 * Calcolo la lista ordinata degli edge che stanno sul boundary delle facce visibili (orizzonte)
-                 */
-                internal::horizonEdgeList(horizonEdges, visibleFaces, horizonVertex, p);
-
-                /**
-                 * Per ogni edge sull'orizzonte, calcolo i punti non ancora inseriti sul convex hull che vedono l'edge,
-                 * ossia l'unione tra gli insiemi di punti che vedono le due facce adiacenti sull'edge.
-                 * Sono tutti i possibili punti che potranno vedere la nuova faccia che verrà costruita unendo l'edge
-                 * sull'orizzonte con next_point.
-                 * P è quindi un array di array: ogni riga i corrisponde all'i-esimo elemento di horizon.
-                 */
-                std::vector< std::set<Pointd> > P;
-                internal::calculateP(P, cg, horizonEdges);
-
-                /**
-                 * Rimuovo next_point dal conflict graph. è fondamentale farlo subito dopo aver rimosso le facce dal
-                 * convex hull: vengono ricalcolati gli indici dei nodi esattamente come vengono ricalcolati quando
-                 * viene rimosso un elemento dalla DCEL.
-                 */
-                cg.deleteLeftNode(p);
-
-                /**
-                 * Elimino dal convex hull tutte le facce di visible_faces e tutti gli half edge ed i vece ad esse
-                 * incidenti, tranne i vertici che stanno sull'orizzonte.
-                 */
-                internal::deleteVisibleFaces(convexHull, horizonVertex, visibleFaces, cg);
-
-
-                /**
-                 * Inserisco le nuove facce nel convex hull, che andranno a collegare gli edge di horizon con
-                 * next_point. Sempre in questa funzione vengono anche calcolati e aggiunti i nuovi conflitti
-                 * tra le nuove facce e i punti presenti nel conflict graph.
-                 */
-                internal::insertNewFaces(convexHull, horizonEdges, p, cg, P);
+    dcel.updateFaceNormals();
+    dcel.updateVertexNormals();
+    dcel.updateBoundingBox();
+    return dcel;
+}
+
+
+/* ----- INTERNAL FUNCTIONS IMPLEMENTATION ----- */
+
+namespace internal {
+
+/**
+ * @brief Inserts in convexHull the hull of points, computed with the algorithm (and the number
+ * of threads) of options, or the approximate hull if options.epsilon or options.maxVertices is
+ * not 0. The order of points may be changed.
+ * @param[out] errorBound: if not nullptr, the error bound of the approximate hull (0 otherwise)
+ * @param[in/out] indices: if not nullptr, an array parallel to points, which is reordered with
+ * them. The randomized incremental and the Quickhull engines set the flag of every vertex of
+ * the hull to the index of its point; with the other engines (and for coplanar points) indices
+ * is cleared
+ * @return false if the computation has been cancelled (convexHull is then empty)
+ */
+inline bool computeConvexHull(Dcel& convexHull, std::vector<Pointd>& points, const ConvexHullOptions& options, double* errorBound, std::vector<unsigned int>* indices)
+{
+    ConvexHullControl control(options.progress, options.deadline, options.cancel, (unsigned int)points.size());
+    if (errorBound != nullptr)
+        *errorBound = 0;
+    if (control.mustStop())
+        return false;
+
+    bool indexed = false; //the flags of the vertices are the indices of their points
+    if (options.epsilon > 0 || options.maxVertices > 0){
+        double bound = approximateQuickHull(convexHull, points, options.epsilon, options.maxVertices, &control);
+        if (errorBound != nullptr)
+            *errorBound = bound;
+    }
+    else switch (options.algorithm) {
+        case QUICKHULL:
+            quickHull(convexHull, points, &control, indices);
+            indexed = true;
+            break;
+        case PARALLEL_DIVIDE_AND_CONQUER:
+            parallelDivideAndConquerConvexHull(convexHull, points, options.nThreads, &control);
+            break;
+        case PARALLEL_QUICKHULL:
+            parallelQuickHull(convexHull, points, options.nThreads, &control);
+            break;
+        case CHAN:
+            chanConvexHull(convexHull, points, 0, &control);
+            break;
+        case LOW_MEMORY_INCREMENTAL:
+            lowMemoryIncrementalConvexHull(convexHull, points, options.insertionOrder, options.nThreads, &control);
+            break;
+        case AUTOMATIC:
+            if (isChanConvenient(points)){
+                chanConvexHull(convexHull, points, 0, &control);
+                break;
             }
-            else
-                cg.deleteLeftNode(p);
-        }
+            //falls through
+        default:
+            if (options.workspace != nullptr)
+                randomizedIncrementalConvexHull(convexHull, points, *options.workspace, options.insertionOrder, options.nThreads, &control, indices);
+            else {
+                ConvexHullWorkspace workspace;
+                randomizedIncrementalConvexHull(convexHull, points, workspace, options.insertionOrder, options.nThreads, &control, indices);
+            }
+            indexed = true;
+    }
+
+    //the partial hull of a cancelled computation is not a valid output
+    if (control.isStopped()){
+        convexHull.clear();
+        return false;
+    }
+
+    /**
+     * Se i punti sono complanari nessun algoritmo inserisce il tetraedro iniziale:
+     * l'output è il convex hull 2D dei punti, sul loro piano.
+     */
+    if (convexHull.numberVertices() == 0){
+        insertFlatHull(convexHull, points);
+        indexed = false;
+    }
+    if (indices != nullptr && !indexed)
+        indices->clear();
+    control.finish();
+    return true;
+}
+
+/**
+ * @brief Inserts in convexHull the hull of points, as computeConvexHull, after the optional
+ * extreme points filter, and fills statistics (if not nullptr). If indices is not nullptr, it
+ * is set to the positions of the points in the input, and then it is updated as in the other
+ * overload.
+ * @return false if the computation has been cancelled (convexHull is then empty)
+ */
+inline bool computeConvexHull(Dcel& convexHull, std::vector<Pointd>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics, std::vector<unsigned int>* indices)
+{
+    unsigned int nInputPoints = (unsigned int)points.size();
+    unsigned int nCulledPoints = 0;
 
-        iterations++;
+    if (indices != nullptr){
+        indices->resize(nInputPoints);
+        for (unsigned int i = 0; i < nInputPoints; i++)
+            (*indices)[i] = i;
+    }
+    if (options.extremePointsFilter)
+        nCulledPoints = extremePointsFilter(points, indices);
+
+    //a local workspace is used to collect the counters of the randomized incremental algorithm
+    ConvexHullWorkspace localWorkspace;
+    ConvexHullOptions workspaceOptions = options;
+    if (workspaceOptions.workspace == nullptr)
+        workspaceOptions.workspace = &localWorkspace;
+    workspaceOptions.workspace->counters = ConvexHullCounters();
+
+    double errorBound = 0;
+    bool completed = computeConvexHull(convexHull, points, workspaceOptions, &errorBound, indices);
+
+    if (statistics != nullptr){
+        statistics->nInputPoints = nInputPoints;
+        statistics->nCulledPoints = nCulledPoints;
+        statistics->counters = workspaceOptions.workspace->counters;
+        statistics->cancelled = !completed;
+        statistics->errorBound = errorBound;
     }
+    return completed;
+}
+
+/**
+ * @brief Returns the hull of points computed as computeConvexHull, with normals and bounding
+ * box. The order of points may be changed.
+ */
+inline Dcel convexHullDcel(std::vector<Pointd>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    Dcel convexHull;
+    computeConvexHull(convexHull, points, options, statistics);
+
+    CG3_CONVEXHULL_COUNT(Timer postProcessingTimer);
     convexHull.updateFaceNormals();
     convexHull.updateVertexNormals();
     convexHull.updateBoundingBox();
+    CG3_CONVEXHULL_COUNT(
+        if (statistics != nullptr)
+            statistics->counters.postProcessingTime = postProcessingTimer.delay();
+    )
+
     return convexHull;
 }
 
+/**
+ * @brief Returns the hull of the range of points [first, end), converted to Pointd: the
+ * generic overload of the dispatch on the point type of convexHull.
+ */
+template <class InputIterator, class T>
+Dcel convexHullRange(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics, const T*)
+{
+    std::vector<Pointd> points(first, end);
+    return convexHullDcel(points, options, statistics);
+}
 
-/* ----- INTERNAL FUNCTIONS IMPLEMENTATION ----- */
+/**
+ * @brief Returns the hull of the range of integer points [first, end), computed exactly by
+ * computeIntegerConvexHull, with normals and bounding box.
+ */
+template <class InputIterator>
+Dcel convexHullRange(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics, const Pointi*)
+{
+    std::vector<Pointi> points(first, end);
+    Dcel convexHull;
+    computeIntegerConvexHull(convexHull, points, options, statistics);
+    convexHull.updateFaceNormals();
+    convexHull.updateVertexNormals();
+    convexHull.updateBoundingBox();
+    return convexHull;
+}
 
-namespace internal {
+/**
+ * @brief Returns the hull of the range of float points [first, end), copied as floats and
+ * computed as the hull of a StridedPointView.
+ */
+template <class InputIterator>
+Dcel convexHullRange(InputIterator first, InputIterator end, const ConvexHullOptions& options, ConvexHullStatistics* statistics, const Pointf*)
+{
+    std::vector<Pointf> points(first, end);
+    return convexHull(StridedPointView<float>(points.data(), (unsigned int)points.size()), options, statistics);
+}
 
-inline double areCoplanar(const Pointd& p0, const Pointd& p1, const Pointd& p2, const Pointd& p3)
+/**
+ * @brief Fills result with the hull vertices and triangles of convexHull, using the indices of
+ * the points in [first, end), that are visited once. hullVertices and vertexIndex are buffers
+ * that can be reused between calls.
+ */
+template <class ForwardIterator>
+void fillHullResult(
+        HullResult& result,
+        const Dcel& convexHull,
+        ForwardIterator first,
+        ForwardIterator end,
+        bool facePlanes,
+        std::unordered_map<Pointd, unsigned int>& hullVertices,
+        std::unordered_map<unsigned int, unsigned int>& vertexIndex)
+{
+    result.vertices.clear();
+    result.triangles.clear();
+    result.planes.clear();
+    hullVertices.clear();
+    vertexIndex.clear();
+
+    //the hull vertices are found in the input with a single pass
+    for (const Dcel::Vertex* v : convexHull.vertexIterator())
+        hullVertices[v->coordinate()] = v->id();
+    result.vertices.reserve(hullVertices.size());
+    unsigned int i = 0;
+    for (ForwardIterator it = first; it != end && vertexIndex.size() < hullVertices.size(); ++it, ++i){
+        auto hv = hullVertices.find(*it);
+        if (hv != hullVertices.end() && vertexIndex.find(hv->second) == vertexIndex.end()){
+            vertexIndex[hv->second] = i;
+            result.vertices.push_back(i);
+        }
+    }
+
+    fillHullTriangles(result, convexHull, facePlanes, [&vertexIndex](const Dcel::Vertex* v){
+        return vertexIndex[v->id()];
+    });
+}
+
+/**
+ * @brief Fills result with the hull vertices and triangles of convexHull, whose vertex flags
+ * are the indices of the input points (see computeConvexHull).
+ */
+inline void fillIndexedHullResult(HullResult& result, const Dcel& convexHull, bool facePlanes)
+{
+    result.vertices.clear();
+    result.triangles.clear();
+    result.planes.clear();
+    result.vertices.reserve(convexHull.numberVertices());
+    for (const Dcel::Vertex* v : convexHull.vertexIterator())
+        result.vertices.push_back((unsigned int)v->flag());
+    fillHullTriangles(result, convexHull, facePlanes, [](const Dcel::Vertex* v){
+        return (unsigned int)v->flag();
+    });
+}
+
+/**
+ * @brief Fills the triangles (and the planes, if facePlanes is true) of result with the faces
+ * of convexHull, whose vertices are mapped by vertexIndex (a function of a const Dcel::Vertex*)
+ * to the indices of the input points.
+ */
+template <class VertexIndex>
+void fillHullTriangles(HullResult& result, const Dcel& convexHull, bool facePlanes, VertexIndex vertexIndex)
+{
+    result.triangles.reserve(3 * convexHull.numberFaces());
+    if (facePlanes)
+        result.planes.reserve(4 * convexHull.numberFaces());
+    for (const Dcel::Face* f : convexHull.faceIterator()){
+        const Dcel::HalfEdge* e = f->outerHalfEdge();
+        const Dcel::Vertex* tv[3] = {e->fromVertex(), e->toVertex(), e->next()->toVertex()};
+        for (unsigned int j = 0; j < 3; j++)
+            result.triangles.push_back(vertexIndex(tv[j]));
+        if (facePlanes){
+            Vec3 n = (tv[1]->coordinate() - tv[0]->coordinate()).cross(tv[2]->coordinate() - tv[0]->coordinate());
+            n.normalize();
+            result.planes.push_back(n.x());
+            result.planes.push_back(n.y());
+            result.planes.push_back(n.z());
+            result.planes.push_back(-n.dot(tv[0]->coordinate()));
+        }
+    }
+}
+
+/**
+ * @brief Randomized incremental convex hull: inserts in convexHull the hull of points.
+ * The points are shuffled with a local random generator, hence the function can be
+ * safely called by multiple threads.
+ */
+inline void randomizedIncrementalConvexHull(Dcel& convexHull, std::vector<Pointd>& points)
+{
+    ConvexHullWorkspace workspace;
+    randomizedIncrementalConvexHull(convexHull, points, workspace);
+}
+
+/**
+ * @brief Randomized incremental convex hull, which uses (and keeps, for the next calls) the
+ * memory of workspace. The random generator of the workspace is reseeded, hence the result
+ * does not depend on the previous calls. With BRIO_ORDER, the shuffled points are reordered
+ * by brioOrder (using nThreads threads). If control is not nullptr, it is polled after every
+ * insertion, and the function returns with a partial hull when it must stop. If indices is not
+ * nullptr, it is an array parallel to points, which is reordered with them, and the flag of
+ * every vertex of the hull is the index of its point.
+ */
+inline void randomizedIncrementalConvexHull(Dcel& convexHull, std::vector<Pointd>& points, ConvexHullWorkspace& workspace, ConvexHullInsertionOrder order, unsigned int nThreads, ConvexHullControl* control, std::vector<unsigned int>* indices)
 {
-    Eigen::Matrix4d m;
-    m << p0.x(), p0.y(), p0.z(), 1,
-         p1.x(), p1.y(), p1.z(), 1,
-         p2.x(), p2.y(), p2.z(), 1,
-         p3.x(), p3.y(), p3.z(), 1;
+    workspace.counters = ConvexHullCounters();
+    CG3_CONVEXHULL_COUNT(Timer phaseTimer);
 
-    return m.determinant();
+    workspace.rng.seed(std::mt19937::default_seed);
+    shufflePoints(points, indices, workspace.rng);
+    if (order == BRIO_ORDER)
+        brioOrder(points, nThreads, indices);
+
+    unsigned int nPoints = (unsigned int)points.size();
+    if (!insertInitialTet(convexHull, points, indices))
+        return;
+    CG3_CONVEXHULL_COUNT(
+        workspace.counters.initializationTime = phaseTimer.delay();
+        phaseTimer.start();
+    )
+
+    /**
+     * Il conflict graph identifica i punti con il loro indice in points e le facce con il loro
+     * id nella Dcel: i primi quattro punti sono già sul convex hull e non vengono inseriti.
+     */
+    workspace.cg.reset(nPoints);
+    workspace.coords.assign(points);
+    initConflictGraph(workspace, convexHull, points, 4);
+    CG3_CONVEXHULL_COUNT(
+        workspace.counters.conflictSetupTime = phaseTimer.delay();
+        phaseTimer.start();
+    )
+    if (control != nullptr && control->mustStop())
+        return;
+
+    for (unsigned int i = 4; i < nPoints && (control == nullptr || !control->poll(i)); i++){ //For every point that is not inserted in the convex hull yet
+        if (insertPoint(convexHull, workspace, points, i) && indices != nullptr)
+            newFacesApex(workspace.newFaces)->setFlag((*indices)[i]);
+    }
+    CG3_CONVEXHULL_COUNT(workspace.counters.insertionTime = phaseTimer.delay());
+}
+
+/**
+ * @brief Shuffles points with rng, as std::shuffle. If indices is not nullptr, it is an array
+ * parallel to points, which is permuted in the same way.
+ */
+inline void shufflePoints(std::vector<Pointd>& points, std::vector<unsigned int>* indices, std::mt19937& rng)
+{
+    if (indices == nullptr){
+        std::shuffle(points.begin(), points.end(), rng);
+        return;
+    }
+    for (unsigned int i = (unsigned int)points.size(); i > 1; i--){
+        unsigned int j = std::uniform_int_distribution<unsigned int>(0, i - 1)(rng);
+        std::swap(points[i-1], points[j]);
+        std::swap((*indices)[i-1], (*indices)[j]);
+    }
+}
+
+/**
+ * @brief Inserts the point points[i] in convexHull, updating the conflict graph and the planes
+ * of the faces of workspace. The conflicts of points[i] must be already in the conflict graph.
+ * All the sets used by the insertion are buffers of the workspace.
+ * @return true if the point was outside the hull (and now it is a vertex of the hull)
+ */
+inline bool insertPoint(
+        Dcel& convexHull,
+        ConvexHullWorkspace& workspace,
+        const std::vector<Pointd>& points,
+        unsigned int i)
+{
+    ConflictGraph& cg = workspace.cg;
+    const Pointd& p = points[i];
+    /**
+     * Se il punto è interno al convex hull, nel conflict graph il nodo associato al punto non
+     * ha archi uscenti: si ignora il punto.
+     */
+    if (cg.sizeConflictsPoint(i) == 0){
+        cg.deletePoint(i);
+        CG3_CONVEXHULL_COUNT(workspace.counters.discardedPoints++);
+        return false;
+    }
+
+    /**
+     * Calcolo l'array delle facce sul convex hull viste da next_point: l'appartenenza di una
+     * faccia all'insieme è data dal suo marcatore nel workspace.
+     */
+    workspace.startInsertion();
+    for (unsigned int f : cg.pointConflicts(i)){
+        workspace.addVisibleFace(convexHull.face(f));
+    }
+    addCoplanarFaces(workspace, p);
+
+    /**
+     * Calcolo la lista ordinata degli edge che stanno sul boundary delle facce visibili (orizzonte)
+     */
+    horizonEdgeList(workspace);
+
+    CG3_CONVEXHULL_COUNT(
+        ConvexHullCounters& counters = workspace.counters;
+        counters.insertedPoints++;
+        counters.visibleFaces += workspace.visibleFaces.size();
+        counters.maxVisibleFaces = std::max(counters.maxVisibleFaces, (unsigned long long)workspace.visibleFaces.size());
+        counters.horizonEdges += workspace.horizonEdges.size();
+        counters.maxHorizonEdges = std::max(counters.maxHorizonEdges, (unsigned long long)workspace.horizonEdges.size());
+        counters.facesDeleted += workspace.visibleFaces.size();
+        counters.facesCreated += workspace.horizonEdges.size();
+        //all the arcs of the visible faces are deleted, including the ones of points[i]
+        for (const Dcel::Face* f : workspace.visibleFaces)
+            counters.conflictArcsDeleted += cg.sizeConflictsFace(f->id());
+    )
+
+    /**
+     * Per ogni edge sull'orizzonte, calcolo i punti non ancora inseriti sul convex hull che vedono l'edge,
+     * ossia l'unione tra gli insiemi di punti che vedono le due facce adiacenti sull'edge.
+     * Sono tutti i possibili punti che potranno vedere la nuova faccia che verrà costruita unendo l'edge
+     * sull'orizzonte con next_point.
+     * P è quindi un array di array: ogni riga i corrisponde all'i-esimo elemento di horizon.
+     */
+    calculateP(workspace, i);
+
+    /**
+     * Rimuovo next_point dal conflict graph, prima di eliminare le facce che vede.
+     */
+    cg.deletePoint(i);
+
+    /**
+     * Elimino dal convex hull tutte le facce di visible_faces e tutti gli half edge ed i vece ad esse
+     * incidenti, tranne i vertici che stanno sull'orizzonte.
+     */
+    deleteVisibleFaces(convexHull, workspace);
+
+
+    /**
+     * Inserisco le nuove facce nel convex hull, che andranno a collegare gli edge di horizon con
+     * next_point, e calcolo i nuovi conflitti tra le nuove facce e i punti presenti nel conflict graph.
+     */
+    std::size_t capacity = workspace.newFaces.capacity();
+    insertNewFaces(convexHull, workspace.horizonEdges, p, workspace.newFaces);
+    workspace.countAllocation(capacity, workspace.newFaces.capacity());
+    updateConflictGraph(workspace, points);
+    workspace.countInsertedPoint();
+    CG3_CONVEXHULL_COUNT(
+        ConvexHullCounters& c = workspace.counters;
+        c.peakConflictArcs = std::max(c.peakConflictArcs, c.conflictArcsCreated - c.conflictArcsDeleted);
+    )
+    return true;
+}
+
+/**
+ * @brief Returns the determinant of the 4x4 matrix whose rows are (p_i, 1), i.e. orient3d:
+ * the value is zero if and only if the points are coplanar, and its sign is exact.
+ */
+inline double areCoplanar(const Pointd& p0, const Pointd& p1, const Pointd& p2, const Pointd& p3)
+{
+    return orient3d(p0, p1, p2, p3);
 }
 
+/**
+ * @brief Returns true if p lies outside the face f or on its plane.
+ */
 inline bool isFaceVisible(const Dcel::Face* f, const Pointd& p)
 {
     Dcel::Face::ConstIncidentVertexIterator vit = f->incidentVertexBegin();
-    Pointd p1 = (*vit)->coordinate();
+    const Pointd& p1 = (*vit)->coordinate();
     vit++;
-    Pointd p2 = (*vit)->coordinate();
+    const Pointd& p2 = (*vit)->coordinate();
     vit++;
-    Pointd p3 = (*vit)->coordinate();
-    double determinant = areCoplanar(p1, p2, p3, p);
+    const Pointd& p3 = (*vit)->coordinate();
+    return areCoplanar(p1, p2, p3, p) <= 0;
+}
 
-    if (determinant > std::numeric_limits<double>::epsilon()) return false;
-    else return true;
+/**
+ * @brief Searches affinely independent points among points[ids[0]], ..., points[ids[n-1]]
+ * (among all the points if ids is nullptr): the first two are far apart, the third is the
+ * farthest from their line and the fourth is the farthest from the plane of the first three.
+ * Every step is a single pass over the candidates.
+ * @return the number of independent points found: 0 if there are no candidates, 1 if all the
+ * points are coincident, 2 if they are collinear, 3 if they are coplanar, 4 otherwise
+ */
+template <class PointArray>
+unsigned int simplexSearch(const PointArray& points, const unsigned int* ids, unsigned int n, unsigned int simplex[4])
+{
+    if (n == 0)
+        return 0;
+    auto id = [ids](unsigned int i) {return ids == nullptr ? i : ids[i];};
+
+    //the farthest point from the first candidate, and the farthest point from it
+    unsigned int s0 = id(0), s1 = id(0);
+    double maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        double d = (points[id(i)] - points[s0]).lengthSquared();
+        if (d > maxDist){
+            maxDist = d;
+            s1 = id(i);
+        }
+    }
+    simplex[0] = s1;
+    if (maxDist == 0)
+        return 1;
+    maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        double d = (points[id(i)] - points[s1]).lengthSquared();
+        if (d > maxDist){
+            maxDist = d;
+            s0 = id(i);
+        }
+    }
+    simplex[0] = s0;
+    simplex[1] = s1;
+
+    //the farthest point from the line s0 s1
+    const Vec3 dir = points[s1] - points[s0];
+    maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        double d = dir.cross(points[id(i)] - points[s0]).lengthSquared();
+        if (d > maxDist){
+            maxDist = d;
+            simplex[2] = id(i);
+        }
+    }
+    if (maxDist == 0)
+        return 2;
+
+    //the farthest point from the plane s0 s1 s2
+    maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        double d = std::fabs(areCoplanar(points[s0], points[s1], points[simplex[2]], points[id(i)]));
+        if (d > maxDist){
+            maxDist = d;
+            simplex[3] = id(i);
+        }
+    }
+    if (maxDist == 0)
+        return 3;
+    return 4;
+}
 
+/**
+ * @brief Searches four non coplanar points in points, and puts their indices in simplex.
+ * The candidates are first searched among the extreme points along the three axes (found in a
+ * single pass), and only if they are degenerate among all the points. Complexity: O(n).
+ * points can be any array of points with size() and operator[] (a std::vector<Pointd>, or a
+ * StridedPointView that converts its coordinates on the fly).
+ * @return the number of affinely independent points found (see simplexSearch): if it is less
+ * than 4, the points are coincident, collinear or coplanar
+ */
+template <class PointArray>
+unsigned int findInitialSimplex(const PointArray& points, unsigned int simplex[4])
+{
+    const unsigned int nPoints = (unsigned int)points.size();
+    if (nPoints == 0)
+        return 0;
+    unsigned int extremes[6] = {0, 0, 0, 0, 0, 0}; //min x, max x, min y, max y, min z, max z
+    for (unsigned int i = 1; i < nPoints; i++){
+        for (unsigned int a = 0; a < 3; a++){
+            if (points[i][a] < points[extremes[2*a]][a])
+                extremes[2*a] = i;
+            else if (points[i][a] > points[extremes[2*a+1]][a])
+                extremes[2*a+1] = i;
+        }
+    }
+    unsigned int n = simplexSearch(points, extremes, 6, simplex);
+    if (n < 4)
+        n = simplexSearch(points, nullptr, nPoints, simplex);
+    return n;
+}
+
+/**
+ * @brief Returns true if p lies strictly outside the face f.
+ */
+inline bool isFaceStrictlyVisible(const Dcel::Face* f, const Pointd& p)
+{
+    const Dcel::HalfEdge* e = f->outerHalfEdge();
+    return areCoplanar(e->fromVertex()->coordinate(), e->toVertex()->coordinate(), e->next()->toVertex()->coordinate(), p) < 0;
+}
+
+/**
+ * @brief Returns true if the three points lie on the same line (exact test).
+ */
+inline bool areCollinear(const Pointd& a, const Pointd& b, const Pointd& c)
+{
+    return orient2d(Point2Dd(a.x(), a.y()), Point2Dd(b.x(), b.y()), Point2Dd(c.x(), c.y())) == 0 &&
+            orient2d(Point2Dd(a.y(), a.z()), Point2Dd(b.y(), b.z()), Point2Dd(c.y(), c.z())) == 0 &&
+            orient2d(Point2Dd(a.z(), a.x()), Point2Dd(b.z(), b.x()), Point2Dd(c.z(), c.x())) == 0;
+}
+
+/**
+ * @brief Returns true if p is collinear with the edge he: the triangle of he and p would be
+ * degenerate, hence the face beyond he (which has p on its plane) must be replaced too.
+ */
+inline bool isCollinearHorizonEdge(const Dcel::HalfEdge* he, const Pointd& p)
+{
+    return areCollinear(he->fromVertex()->coordinate(), he->toVertex()->coordinate(), p);
+}
+
+/**
+ * @brief Extends the faces visible by p (all the faces strictly visible by p) with the faces
+ * which have p on their plane and must be replaced to keep the hull valid and its vertices
+ * extreme:
+ * - the face beyond a horizon edge collinear with p (see isCollinearHorizonEdge);
+ * - all the faces around a horizon vertex v whose faces that are not visible all have p on
+ *   their plane: they contain the line through v and p, hence v would not be extreme.
+ * Only the faces around the horizon are tested, so a large facet coplanar with p is replaced
+ * only where it is needed. stack must contain the visible faces; the added faces are pushed
+ * on it and examined in turn.
+ * @param[in] isVisible: returns true if a face is in the visible set
+ * @param[in] addVisible: adds a face to the visible set and pushes it on stack
+ */
+template <class IsVisible, class AddVisible>
+void extendVisibleFaces(std::vector<Dcel::Face*>& stack, const Pointd& p, IsVisible isVisible, AddVisible addVisible)
+{
+    while (stack.size() > 0){
+        Dcel::Face* g = stack.back();
+        stack.pop_back();
+        for (Dcel::HalfEdge* he : g->incidentHalfEdgeIterator()){
+            Dcel::Face* adj = he->twin()->face();
+            if (isVisible(adj))
+                continue;
+            if (isCollinearHorizonEdge(he, p)){
+                addVisible(adj);
+                continue;
+            }
+            //the faces around the horizon vertex he->fromVertex(), from the face beyond he
+            bool onPlanes = true;
+            Dcel::HalfEdge* e = he->twin()->next();
+            for (; e != he && onPlanes; e = e->twin()->next()){
+                if (!isVisible(e->face()) && !isFaceVisible(e->face(), p))
+                    onPlanes = false;
+            }
+            if (onPlanes){
+                for (e = he->twin()->next(); e != he; e = e->twin()->next()){
+                    if (!isVisible(e->face()))
+                        addVisible(e->face());
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adds to the visible faces of workspace, which are strictly visible by p, the faces
+ * that must be replaced with them (see extendVisibleFaces).
+ */
+inline void addCoplanarFaces(ConvexHullWorkspace& workspace, const Pointd& p)
+{
+    std::vector<Dcel::Face*>& stack = workspace.stack;
+    stack.clear();
+    for (Dcel::Face* f : workspace.visibleFaces)
+        workspace.push(stack, f);
+    extendVisibleFaces(
+                stack,
+                p,
+                [&workspace](const Dcel::Face* f){ return workspace.isVisible(f); },
+                [&workspace, &stack](Dcel::Face* f){
+                    workspace.addVisibleFace(f);
+                    workspace.push(stack, f);
+                });
+}
+
+/**
+ * @brief Moves in the first four positions of points four non coplanar points, and inserts in
+ * dcel the tetrahedron composed of them. If indices is not nullptr, it is an array parallel to
+ * points, which is reordered with them, and the flags of the four vertices are the indices of
+ * their points.
+ * @return false if the points are coplanar: in this case nothing is inserted in dcel
+ */
+inline bool insertInitialTet(Dcel& dcel, std::vector<Pointd>& points, std::vector<unsigned int>* indices)
+{
+    unsigned int simplex[4];
+    if (findInitialSimplex(points, simplex) < 4)
+        return false;
+
+    /**
+     * Gli scambi devono tenere conto degli indici già spostati: se, ad esempio, b == 0,
+     * dopo il primo scambio il punto b si trova in posizione a.
+     */
+    unsigned int positions[4] = {simplex[0], simplex[1], simplex[2], simplex[3]};
+    for (unsigned int i = 0; i < 4; i++){
+        std::swap(points[i], points[positions[i]]);
+        if (indices != nullptr)
+            std::swap((*indices)[i], (*indices)[positions[i]]);
+        for (unsigned int j = i+1; j < 4; j++){
+            if (positions[j] == i)
+                positions[j] = positions[i];
+        }
+    }
+
+    if (areCoplanar(points[0], points[1], points[2], points[3]) > 0)
+        insertTet(dcel, points[0], points[1], points[2], points[3]);
+    else
+        insertTet(dcel, points[1], points[0], points[2], points[3]);
+    if (indices != nullptr){
+        for (Dcel::Vertex* v : dcel.vertexIterator()){
+            for (unsigned int i = 0; i < 4; i++){
+                if (v->coordinate() == points[i])
+                    v->setFlag((*indices)[i]);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Inserts in dcel the convex hull of degenerate (coplanar) points: a single vertex if
+ * the points are coincident, the two end points if they are collinear, and otherwise the convex
+ * polygon of the points on their plane. The polygon is triangulated as a fan on both its sides,
+ * from two different vertices, so that the result is a closed flat triangle mesh (every half
+ * edge has a twin, and the Euler characteristic is 2).
+ * points can be any array of points, as in findInitialSimplex.
+ */
+template <class PointArray>
+void insertFlatHull(Dcel& dcel, const PointArray& points)
+{
+    unsigned int simplex[4];
+    unsigned int n = findInitialSimplex(points, simplex);
+    if (n == 0)
+        return;
+    if (n < 3){
+        for (unsigned int i = 0; i < n; i++)
+            dcel.addVertex(points[simplex[i]]);
+        return;
+    }
+
+    //projection on the coordinate plane where the polygon has the largest area
+    const Pointd& p0 = points[simplex[0]];
+    Vec3 normal = (points[simplex[1]] - p0).cross(points[simplex[2]] - p0);
+    unsigned int axis = 0;
+    if (std::fabs(normal.y()) > std::fabs(normal[axis])) axis = 1;
+    if (std::fabs(normal.z()) > std::fabs(normal[axis])) axis = 2;
+    const unsigned int u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+    std::vector<unsigned int> ids(points.size());
+    for (unsigned int i = 0; i < ids.size(); i++)
+        ids[i] = i;
+    std::sort(ids.begin(), ids.end(), [&](unsigned int a, unsigned int b){
+        if (points[a][u] != points[b][u])
+            return points[a][u] < points[b][u];
+        return points[a][v] < points[b][v];
+    });
+
+    //Andrew's monotone chain: the hull is in counterclockwise order on the projection plane
+    auto orient = [&](unsigned int a, unsigned int b, unsigned int c){
+        return orient2d(
+                    Point2Dd(points[a][u], points[a][v]),
+                    Point2Dd(points[b][u], points[b][v]),
+                    Point2Dd(points[c][u], points[c][v]));
+    };
+    std::vector<unsigned int> polygon(2 * ids.size());
+    unsigned int k = 0;
+    for (unsigned int i = 0; i < ids.size(); i++){
+        while (k >= 2 && orient(polygon[k-2], polygon[k-1], ids[i]) <= 0)
+            k--;
+        polygon[k++] = ids[i];
+    }
+    for (unsigned int i = (unsigned int)ids.size() - 1, t = k + 1; i > 0; i--){
+        while (k >= t && orient(polygon[k-2], polygon[k-1], ids[i-1]) <= 0)
+            k--;
+        polygon[k++] = ids[i-1];
+    }
+    polygon.resize(k - 1);
+
+    std::vector<Dcel::Vertex*> vertices(polygon.size());
+    for (unsigned int i = 0; i < polygon.size(); i++)
+        vertices[i] = dcel.addVertex(points[polygon[i]]);
+
+    /**
+     * Il lato frontale è un ventaglio dal vertice 0, quello posteriore un ventaglio dal vertice 1
+     * (in ordine inverso): le diagonali dei due lati sono diverse, quindi ogni half edge
+     * orientato compare una sola volta e il twin di un lato del bordo è sull'altro lato.
+     */
+    const unsigned int m = (unsigned int)vertices.size();
+    std::vector<unsigned int> triangles;
+    triangles.reserve(6 * (m - 2));
+    for (unsigned int i = 1; i+1 < m; i++){
+        unsigned int front[3] = {0, i, i+1};
+        triangles.insert(triangles.end(), front, front+3);
+    }
+    for (unsigned int i = m; i > 2; i--){
+        unsigned int back[3] = {1, i % m, i-1};
+        triangles.insert(triangles.end(), back, back+3);
+    }
+    insertTriangles(dcel, vertices, triangles);
+    assert(dcel.numberVertices() - dcel.numberHalfEdges() / 2 + dcel.numberFaces() == 2);
+}
+
+/**
+ * @brief Inserts in dcel the triangles of a closed triangle mesh: triangles contains three
+ * positions in vertices (vertices already inserted in dcel) for every triangle. The twin of
+ * every half edge is the half edge with opposite vertices.
+ */
+inline void insertTriangles(Dcel& dcel, const std::vector<Dcel::Vertex*>& vertices, const std::vector<unsigned int>& triangles)
+{
+    std::map<std::pair<Dcel::Vertex*, Dcel::Vertex*>, Dcel::HalfEdge*> edges;
+    for (unsigned int t = 0; t+2 < triangles.size(); t += 3){
+        Dcel::Vertex* tv[3] = {vertices[triangles[t]], vertices[triangles[t+1]], vertices[triangles[t+2]]};
+        Dcel::HalfEdge* te[3];
+        Dcel::Face* f = dcel.addFace();
+        for (unsigned int i = 0; i < 3; i++){
+            te[i] = dcel.addHalfEdge();
+            te[i]->setFromVertex(tv[i]);
+            te[i]->setToVertex(tv[(i+1)%3]);
+            te[i]->setFace(f);
+            tv[i]->setIncidentHalfEdge(te[i]);
+            edges[std::make_pair(tv[i], tv[(i+1)%3])] = te[i];
+        }
+        for (unsigned int i = 0; i < 3; i++){
+            te[i]->setNext(te[(i+1)%3]);
+            te[i]->setPrev(te[(i+2)%3]);
+        }
+        f->setOuterHalfEdge(te[0]);
+    }
+    for (auto& e : edges)
+        e.second->setTwin(edges[std::make_pair(e.first.second, e.first.first)]);
 }
 
 inline void insertTet(Dcel& dcel, const Pointd& p0, const Pointd& p1, const Pointd& p2, const Pointd& p3)
@@ -338,7 +1447,12 @@ inline void insertTet(Dcel& dcel, const Pointd& p0, const Pointd& p1, const Poin
     dcel.updateVertexNormals();
 }
 
-inline void horizonEdgeList(std::vector<Dcel::HalfEdge*>& horizon, const std::set<Dcel::Face*>& visibleFaces, std::set<Dcel::Vertex*>& horizonVertex, const Pointd& next_point)
+/**
+ * @brief Computes in horizon the ordered list of the half edges (outside the visible faces) on
+ * the boundary of visibleFaces, and in horizonVertex their vertices. A face is visible if and
+ * only if it is in visibleFaces: no predicate is evaluated.
+ */
+inline void horizonEdgeList(std::vector<Dcel::HalfEdge*>& horizon, const std::set<Dcel::Face*>& visibleFaces, std::set<Dcel::Vertex*>& horizonVertex)
 {
     Dcel::HalfEdge* e0 = nullptr ,*e1;
     Dcel::HalfEdge* first_boundary_edge;
@@ -354,7 +1468,7 @@ inline void horizonEdgeList(std::vector<Dcel::HalfEdge*>& horizon, const std::se
             e0 = *heit;
             e1 = e0->twin();
             adiacent_face = e1->face();
-            sees=isFaceVisible(adiacent_face, next_point);
+            sees = visibleFaces.find(adiacent_face) != visibleFaces.end();
             if (!sees)
                 finded = true;
         }
@@ -374,7 +1488,7 @@ inline void horizonEdgeList(std::vector<Dcel::HalfEdge*>& horizon, const std::se
     do { // finchè non incontro nuovamente first_boundary_edge
         e1 = e0->twin(); // e1: twin di e0
         adiacent_face = e1->face(); // f: faccia incidente a e1
-        sees=isFaceVisible(adiacent_face, next_point);
+        sees = visibleFaces.find(adiacent_face) != visibleFaces.end();
         if (!sees) { // se f è una faccia non visibile
             // Allora e0/e1 sono sull'orizzonte!
             horizon.push_back(e1);
@@ -392,27 +1506,73 @@ inline void horizonEdgeList(std::vector<Dcel::HalfEdge*>& horizon, const std::se
     // finché non ho ritrovaro il primo bordo
 }
 
-inline void calculateP(std::vector< std::set<Pointd> > &P, const BipartiteGraph<Pointd, unsigned int> &cg, std::vector<Dcel::HalfEdge*> &horizonEdges)
+/**
+ * @brief Computes in the horizon edges of workspace the ordered list of the half edges (outside
+ * the visible faces) on the boundary of the visible faces of workspace, and marks their vertices.
+ * The visible faces are already marked in the workspace, hence the walk only follows the
+ * topology of the Dcel, and no predicate is evaluated.
+ */
+inline void horizonEdgeList(ConvexHullWorkspace& workspace)
 {
-    Dcel::HalfEdge* he0, *he1;
-    Dcel::Face* f0, *f1;
+    Dcel::HalfEdge* e0 = nullptr, *e1 = nullptr;
+    bool found = false;
 
-    P.clear();
-    P.resize(horizonEdges.size());
+    /** Ciclo di ricerca della Faccia sul boundary*/
+    for (unsigned int i = 0; i < workspace.visibleFaces.size() && !found; i++){
+        Dcel::Face* f = workspace.visibleFaces[i];
+        for (Dcel::Face::IncidentHalfEdgeIterator heit = f->incidentHalfEdgeBegin(); heit != f->incidentHalfEdgeEnd() && !found; ++heit){
+            e0 = *heit;
+            e1 = e0->twin();
+            found = !workspace.isVisible(e1->face());
+        }
+    }
+    assert(found);
+
+    // e0: half edge interno alla faccia col bordo nell'orizzonte, e1: il suo twin
+    workspace.push(workspace.horizonEdges, e1);
+    workspace.markVertex(e0->fromVertex());
+
+    Dcel::HalfEdge* firstBoundaryEdge = e0;
+    e0 = e0->next();
+    do {
+        e1 = e0->twin();
+        if (!workspace.isVisible(e1->face())) { // e0/e1 sono sull'orizzonte
+            workspace.push(workspace.horizonEdges, e1);
+            workspace.markVertex(e0->fromVertex());
+            e0 = e0->next();
+        }
+        else { // giro attorno al from vertex di e0
+            e0 = e1->next();
+        }
+    } while (e0 != firstBoundaryEdge);
+}
+
+/**
+ * @brief For every horizon edge of workspace, computes in P the points (except pid) that see
+ * one of the two faces adjacent to the edge: they are the only points that can see the new face
+ * built on the edge.
+ */
+inline void calculateP(ConvexHullWorkspace& workspace, unsigned int pid)
+{
+    std::vector<std::vector<unsigned int> >& P = workspace.P;
+    const std::vector<Dcel::HalfEdge*>& horizonEdges = workspace.horizonEdges;
+
+    if (P.size() < horizonEdges.size()){
+        std::size_t capacity = P.capacity();
+        P.resize(horizonEdges.size());
+        workspace.countAllocation(capacity, P.capacity());
+    }
     for (unsigned int i=0; i<horizonEdges.size(); i++){
-        he0 = horizonEdges[i];
-        he1 = he0->twin();
-        f0 = he0->face();
-        f1 = he1->face();
-        // viene inserito in P[i] l'array ordinato contente i punti visibili da f0 e f1
-        for (const Pointd& p : cg.adjacentRightNodeIterator(f0->id()))
-            P[i].insert(p);
-        for (const Pointd& p : cg.adjacentRightNodeIterator(f1->id()))
-            P[i].insert(p);
+        Dcel::HalfEdge* he0 = horizonEdges[i];
+        Dcel::HalfEdge* he1 = he0->twin();
+        // viene inserito in P[i] l'array contente i punti visibili da f0 e f1, escluso il punto pid
+        std::size_t capacity = P[i].capacity();
+        workspace.cg.faceConflictsUnion(he0->face()->id(), he1->face()->id(), pid, P[i]);
+        workspace.countAllocation(capacity, P[i].capacity());
     }
 }
 
-inline void deleteVisibleFaces(Dcel & ch, std::set<Dcel::Vertex*>& horizonVertices, const std::set<Dcel::Face*> &visibleFaces, BipartiteGraph<Pointd, unsigned int>& cg)
+inline void deleteVisibleFaces(Dcel & ch, std::set<Dcel::Vertex*>& horizonVertices, const std::set<Dcel::Face*> &visibleFaces, ConflictGraph& cg)
 {
     std::set<Dcel::Vertex*> garbage_vertex;      // array di vertici da eliminare a fine computazione
 
@@ -448,7 +1608,7 @@ inline void deleteVisibleFaces(Dcel & ch, std::set<Dcel::Vertex*>& horizonVertic
         ch.deleteHalfEdge(e3);
 
         /** eliminazione della faccia f */
-        cg.deleteRightNode(f->id());
+        cg.deleteFace(f->id());
         ch.deleteFace(f);
         /** Salvo i vertici da eliminare nell'array garbage_vertex */
 
@@ -466,7 +1626,39 @@ inline void deleteVisibleFaces(Dcel & ch, std::set<Dcel::Vertex*>& horizonVertic
     }
 }
 
-inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*> & horizonEdges, const Pointd & p, BipartiteGraph<Pointd, unsigned int>& cg, std::vector<std::set<Pointd> >& P)
+/**
+ * @brief Deletes from ch the visible faces of workspace, with their half edges and their
+ * vertices which are not marked (i.e. are not on the horizon).
+ */
+inline void deleteVisibleFaces(Dcel& ch, ConvexHullWorkspace& workspace)
+{
+    /**
+     * I vertici vengono eliminati dopo le facce, in quanto possono essere condivisi tra più
+     * facce: il marcatore nel workspace garantisce che ogni vertice sia eliminato una sola volta.
+     */
+    for (Dcel::Face* f : workspace.visibleFaces){
+        Dcel::HalfEdge* e1 = f->outerHalfEdge();
+        Dcel::HalfEdge* e2 = e1->next();
+        Dcel::HalfEdge* e3 = e2->next();
+        Dcel::Vertex* v[3] = {e1->fromVertex(), e1->toVertex(), e2->toVertex()};
+
+        ch.deleteHalfEdge(e1);
+        ch.deleteHalfEdge(e2);
+        ch.deleteHalfEdge(e3);
+        workspace.cg.deleteFace(f->id());
+        ch.deleteFace(f);
+
+        for (unsigned int j = 0; j < 3; j++){
+            if (workspace.markVertex(v[j]))
+                workspace.push(workspace.deletedVertices, v[j]);
+        }
+    }
+
+    for (Dcel::Vertex* v : workspace.deletedVertices)
+        ch.deleteVertex(v);
+}
+
+inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*> & horizonEdges, const Pointd & p, std::vector<Dcel::Face*>& newFaces)
 {
     Dcel::Vertex* v3, *v1, *v2;                   // id di vertici della faccia inserita: v3 è SEMPRE l'id del nuovo punto inserito nel ch.
     Dcel::HalfEdge* e1, *e2, *e3;                     // id degli half edge della faccia inserita: e1 è il twin dell'edge sull'orizzonte
@@ -484,6 +1676,9 @@ inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*> & horizonEdg
      * dell'ultima faccia (e2).
      */
 
+    newFaces.clear();
+    newFaces.reserve(horizonEdges.size());
+
     /** Inserisco il nuovo punto (v3) */
     v3 = ch.addVertex(p); // inserisco il nuovo punto
 
@@ -534,14 +1729,7 @@ inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*> & horizonEdg
     v2->setIncidentHalfEdge(e2);
     v3->setIncidentHalfEdge(e3);
 
-    cg.addRightNode(f->id()); // aggiungo f al conflict_graph
-
-    /** CHECK VISIBILITà f */
-    for (const Pointd& point: P[0]){
-        if (isFaceVisible(f, point)){
-            cg.addArc(point, f->id());
-        }
-    }
+    newFaces.push_back(f);
 
     //ad ogni ciclo, il twin del nuovo e3 è il vecchio e2.
     for (unsigned int i=1; i<horizonEdges.size(); i++){ // per ogni edge  sull'orizzonte
@@ -592,18 +1780,134 @@ inline void insertNewFaces (Dcel & ch, std::vector<Dcel::HalfEdge*> & horizonEdg
         v1->setIncidentHalfEdge(e1);
         v2->setIncidentHalfEdge(e2);
 
-        cg.addRightNode(f->id());
+        newFaces.push_back(f);
+    }
 
-        /** CHECK VISIBILITà f */
-        for (const Pointd& point: P[i]){
-            if (isFaceVisible(f, point))
-                cg.addArc(point, f->id()); // se point vede f, aggiungo il conflitto nel conflict graph
+    e2->setTwin(old_e3);
+    old_e3->setTwin(e2);
+}
+
+/**
+ * @brief Returns the vertex inserted by insertNewFaces, which is shared by all the new faces:
+ * it is the origin of the previous half edge of the outer half edge of every new face.
+ */
+inline Dcel::Vertex* newFacesApex(const std::vector<Dcel::Face*>& newFaces)
+{
+    return newFaces[0]->outerHalfEdge()->prev()->fromVertex();
+}
+
+/**
+ * @brief Stores in planes the plane of the face f.
+ */
+inline void setFacePlane(FacePlanes& planes, const Dcel::Face* f)
+{
+    const Dcel::HalfEdge* e = f->outerHalfEdge();
+    planes.setFace(f->id(), e->fromVertex()->coordinate(), e->toVertex()->coordinate(), e->next()->toVertex()->coordinate());
+}
+
+/**
+ * @brief Adds to the conflict graph of workspace all the faces of convexHull, and the conflicts
+ * between them and the points that are not in the hull yet (points[begin], points[begin+1], ...).
+ * A point is in conflict with a face only if it is strictly outside it, hence points on the
+ * boundary of the hull (e.g. duplicated points) are never inserted.
+ */
+inline void initConflictGraph(ConvexHullWorkspace& workspace, const Dcel& convexHull, const std::vector<Pointd>& points, unsigned int begin)
+{
+    const unsigned int nPoints = (unsigned int)points.size();
+    std::vector<signed char>& sides = workspace.sides;
+    for (const Dcel::Face* f : convexHull.faceIterator()){
+        workspace.cg.addFace(f->id());
+        setFacePlane(workspace.planes, f);
+
+        std::size_t capacity = sides.capacity();
+        workspace.planes.classify(f->id(), workspace.coords, begin, nPoints, sides);
+        workspace.countAllocation(capacity, sides.capacity());
+        CG3_CONVEXHULL_COUNT(workspace.counters.planeTests += sides.size());
+        for (unsigned int k = 0; k < sides.size(); k++){
+            CG3_CONVEXHULL_COUNT(if (sides[k] == 0) workspace.counters.orientationTests++);
+            if (sides[k] > 0 || (sides[k] == 0 && isFaceStrictlyVisible(f, points[begin+k]))){
+                workspace.cg.addArc(begin+k, f->id());
+                CG3_CONVEXHULL_COUNT(workspace.counters.conflictArcsCreated++);
+            }
         }
+    }
+    CG3_CONVEXHULL_COUNT(workspace.counters.peakConflictArcs = workspace.counters.conflictArcsCreated);
+}
 
+/**
+ * @brief Adds to the conflict graph of workspace all the faces of convexHull, and the conflicts
+ * of the points, each strictly outside the face with id located[i] (e.g. found by a walk).
+ * The faces strictly visible from a point outside a convex hull are connected, hence the
+ * conflicts of a point are found by flooding from its located face: the cost is proportional
+ * to the number of conflicts, and not to the number of faces of the hull.
+ * @return false if the conflicts are more than maxArcs: the conflict graph is then incomplete
+ */
+inline bool initLocatedConflictGraph(ConvexHullWorkspace& workspace, Dcel& convexHull, const std::vector<Pointd>& points, const std::vector<unsigned int>& located, unsigned long long maxArcs)
+{
+    unsigned long long nArcs = 0;
+    for (const Dcel::Face* f : convexHull.faceIterator())
+        workspace.cg.addFace(f->id());
+    std::vector<Dcel::Face*>& stack = workspace.stack;
+    for (unsigned int i = 0; i < points.size(); i++){
+        workspace.startInsertion();
+        stack.clear();
+        Dcel::Face* f = convexHull.face(located[i]);
+        workspace.addVisibleFace(f);
+        workspace.push(stack, f);
+        while (!stack.empty()){
+            Dcel::Face* g = stack.back();
+            stack.pop_back();
+            workspace.cg.addArc(i, g->id());
+            CG3_CONVEXHULL_COUNT(workspace.counters.conflictArcsCreated++);
+            if (++nArcs > maxArcs){
+                workspace.startInsertion();
+                return false;
+            }
+            for (Dcel::HalfEdge* he : g->incidentHalfEdgeIterator()){
+                Dcel::Face* adj = he->twin()->face();
+                if (!workspace.isVisible(adj) && isFaceStrictlyVisible(adj, points[i])){
+                    workspace.addVisibleFace(adj);
+                    workspace.push(stack, adj);
+                }
+            }
+        }
     }
+    workspace.startInsertion();
+    CG3_CONVEXHULL_COUNT(workspace.counters.peakConflictArcs = workspace.counters.conflictArcsCreated);
+    return true;
+}
 
-    e2->setTwin(old_e3);
-    old_e3->setTwin(e2);
+/**
+ * @brief Adds to the conflict graph of workspace the new faces, and the conflicts between them
+ * and the points that could see them: newFaces[i] can be seen only by the points in P[i].
+ * The plane of every new face is cached in the workspace, and the points of P[i] are classified
+ * in a single pass; only the points that are too close to the plane are tested with the exact
+ * predicate.
+ */
+inline void updateConflictGraph(ConvexHullWorkspace& workspace, const std::vector<Pointd>& points)
+{
+    ConflictGraph& cg = workspace.cg;
+    std::vector<signed char>& sides = workspace.sides;
+    for (unsigned int i=0; i<workspace.newFaces.size(); i++){
+        Dcel::Face* f = workspace.newFaces[i];
+        const std::vector<unsigned int>& candidates = workspace.P[i];
+        cg.addFace(f->id()); // aggiungo f al conflict_graph
+        setFacePlane(workspace.planes, f);
+
+        /** CHECK VISIBILITà f */
+        std::size_t capacity = sides.capacity();
+        workspace.planes.classify(f->id(), workspace.coords, candidates, sides);
+        workspace.countAllocation(capacity, sides.capacity());
+        CG3_CONVEXHULL_COUNT(workspace.counters.planeTests += sides.size());
+        for (unsigned int k = 0; k < sides.size(); k++){
+            unsigned int pid = candidates[k];
+            CG3_CONVEXHULL_COUNT(if (sides[k] == 0) workspace.counters.orientationTests++);
+            if (sides[k] > 0 || (sides[k] == 0 && isFaceStrictlyVisible(f, points[pid]))){
+                cg.addArc(pid, f->id()); // se point vede f, aggiungo il conflitto nel conflict graph
+                CG3_CONVEXHULL_COUNT(workspace.counters.conflictArcsCreated++);
+            }
+        }
+    }
 }
 
 } //namespace cg3::internal
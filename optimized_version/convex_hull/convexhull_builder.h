@@ -0,0 +1,77 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_BUILDER_H
+#define CG3_CONVEXHULL_BUILDER_H
+
+#include "convexhull.h"
+
+namespace cg3 {
+
+/**
+ * @brief The ConvexHullBuilder class computes the convex hull of a set of points that is
+ * given in batches: every call of insert() updates the current hull with a new batch of
+ * points, without recomputing the hull of all the points inserted so far.
+ *
+ * Every point of a batch is first located in the current hull: points inside the largest ball
+ * centered in the centroid of the hull and contained in the hull are discarded in constant
+ * time, the others with a visibility walk from the last located face to the face crossed by
+ * the ray from the centroid through the point (see internal::locateFace). These points are
+ * visited along a Hilbert curve, so that consecutive walks are short. Only the points strictly
+ * outside the hull are kept: they are inserted with the randomized incremental algorithm,
+ * starting from the current hull, and the conflict graph is built only for them, flooding the
+ * faces they see from the face found by the walk. Hence a batch inside the hull costs a short
+ * walk per point and leaves the hull unchanged, and a batch outside it costs as the insertion
+ * of its points in the randomized incremental algorithm, whatever the size of the hull: after
+ * a batch, only the normals of the new faces are computed, and the ball is recomputed only
+ * when the number of vertices of the hull has doubled (the hull only grows, hence the old ball
+ * is still inside it).
+ *
+ * Until the inserted points are all coplanar, the hull is their flat hull (as in convexHull),
+ * and only its vertices are stored.
+ */
+class ConvexHullBuilder
+{
+public:
+    ConvexHullBuilder();
+
+    void insert(const Pointd& point);
+    template <class InputContainer>
+    void insert(const InputContainer& points);
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator end);
+
+    const Dcel& hull() const;
+    unsigned int size() const;
+
+protected:
+    bool isInside(const Pointd& p);
+    void insertBatch();
+    void updateHull();
+    void updateNewFaces();
+
+    Dcel convexHull;
+    std::vector<Pointd> candidates; //points of the current batch outside the inner ball
+    std::vector<Pointd> points; //outside points of the current batch (or the vertices of the flat hull)
+    std::vector<unsigned int> located; //ids of the faces seen by the outside points, found by isInside
+    std::vector<unsigned int> newFaces; //ids of the faces created by the current batch
+    bool coplanar; //the points inserted so far are coplanar
+
+    ConvexHullWorkspace workspace;
+
+    Pointd innerCenter; //center and squared radius of a ball contained in the hull
+    double innerSquaredRadius;
+    bool centerInside; //innerCenter is strictly inside the hull, and the walks can start from it
+    unsigned int lastFace; //the id of the last located face
+    unsigned int ballVertices; //number of vertices of the hull when the ball was computed
+};
+
+} //namespace cg3
+
+#include "convexhull_builder.tpp"
+
+#endif // CG3_CONVEXHULL_BUILDER_H
@@ -0,0 +1,251 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull_builder.h"
+
+namespace cg3 {
+
+/**
+ * @brief ConvexHullBuilder::ConvexHullBuilder
+ * Default constructor. It creates a builder with no points and an empty hull.
+ */
+inline ConvexHullBuilder::ConvexHullBuilder() :
+    coplanar(true),
+    innerSquaredRadius(0),
+    centerInside(false),
+    lastFace(0),
+    ballVertices(0)
+{
+}
+
+/**
+ * @brief ConvexHullBuilder::insert
+ * Inserts a single point in the hull.
+ * @param[in] point
+ */
+inline void ConvexHullBuilder::insert(const Pointd& point)
+{
+    insert(&point, &point + 1);
+}
+
+/**
+ * @brief ConvexHullBuilder::insert
+ * Inserts a batch of points in the hull.
+ * @param[in] container: any container of Pointd with begin() and end()
+ */
+template <class InputContainer>
+void ConvexHullBuilder::insert(const InputContainer& container)
+{
+    insert(container.begin(), container.end());
+}
+
+/**
+ * @brief ConvexHullBuilder::insert
+ * Inserts the batch of points [first, end) in the hull.
+ * @param[in] first
+ * @param[in] end
+ */
+template <class InputIterator>
+void ConvexHullBuilder::insert(InputIterator first, InputIterator end)
+{
+    if (coplanar){
+        points.insert(points.end(), first, end);
+        convexHull.clear();
+        if (points.size() >= 4 && !internal::areAllCoplanar(points)){
+            coplanar = false;
+            internal::randomizedIncrementalConvexHull(convexHull, points, workspace);
+            std::vector<Pointd>().swap(points);
+        }
+        else {
+            //the hull of the next points is the hull of the next points and of the flat hull vertices
+            internal::insertFlatHull(convexHull, points);
+            points.clear();
+            for (const Dcel::Vertex* v : convexHull.vertexIterator())
+                points.push_back(v->coordinate());
+        }
+        updateHull();
+    }
+    else {
+        /**
+         * I punti fuori dalla palla interna sono ordinati lungo una curva di Hilbert: punti
+         * consecutivi sono vicini, quindi ogni walk parte da una faccia vicina a quella cercata.
+         */
+        candidates.clear();
+        for (; first != end; ++first){
+            Vec3 d = *first - innerCenter;
+            if (d.dot(d) >= innerSquaredRadius)
+                candidates.push_back(*first);
+        }
+        internal::hilbertOrder(candidates, 1);
+        points.clear();
+        located.clear();
+        for (const Pointd& p : candidates){
+            if (!isInside(p)){
+                points.push_back(p);
+                located.push_back(lastFace);
+            }
+        }
+        if (!points.empty())
+            insertBatch();
+    }
+}
+
+/**
+ * @brief ConvexHullBuilder::hull
+ * @return the convex hull of all the points inserted so far (their flat hull, if they are coplanar)
+ */
+inline const Dcel& ConvexHullBuilder::hull() const
+{
+    return convexHull;
+}
+
+/**
+ * @brief ConvexHullBuilder::size
+ * @return the number of vertices of the current hull
+ */
+inline unsigned int ConvexHullBuilder::size() const
+{
+    return convexHull.numberVertices();
+}
+
+/**
+ * @brief ConvexHullBuilder::isInside
+ * Locates p, which is outside the inner ball, in the current hull (not flat) with a walk from
+ * the last located face to the face crossed by the ray from the center of the ball through p.
+ * @param[in] p
+ * @return true if p is inside the hull or on its boundary
+ */
+inline bool ConvexHullBuilder::isInside(const Pointd& p)
+{
+    if (!centerInside)
+        return false;
+
+    const unsigned int maxSteps = 16; //steps of the walk from the last face, as in lowMemoryIncrementalConvexHull
+    Dcel::Face* start = convexHull.face(lastFace);
+    if (start == nullptr)
+        start = *convexHull.faceBegin();
+    Dcel::Face* f = internal::walkToFace(start, innerCenter, p, maxSteps);
+    if (f == nullptr)
+        f = internal::locateFace(convexHull, start, innerCenter, p);
+    lastFace = f->id();
+    return !internal::isFaceStrictlyVisible(f, p);
+}
+
+/**
+ * @brief ConvexHullBuilder::insertBatch
+ * Inserts in the current hull the points of the current batch, which are all outside the
+ * hull, in random order. If they have been located by isInside, their conflicts are found
+ * from their located faces; if they are more than a rebuild would create (the batch sees a
+ * large part of the hull, e.g. it surrounds it), the hull of the batch and of the vertices of
+ * the hull is computed from scratch.
+ */
+inline void ConvexHullBuilder::insertBatch()
+{
+    unsigned int nPoints = (unsigned int)points.size();
+    for (unsigned int i = nPoints; i > 1; i--){
+        unsigned int j = std::uniform_int_distribution<unsigned int>(0, i-1)(workspace.rng);
+        std::swap(points[i-1], points[j]);
+        if (centerInside)
+            std::swap(located[i-1], located[j]);
+    }
+
+    /**
+     * Tutti i punti del batch precedente sono stati inseriti o scartati: le liste dei conflitti
+     * sono vuote, e il conflict graph può essere ricostruito per i soli punti del nuovo batch.
+     * Se i punti sono stati localizzati, i loro conflitti sono le facce viste dalla faccia trovata
+     * dal walk; altrimenti ogni punto è confrontato con tutte le facce.
+     */
+    workspace.cg.reset(nPoints);
+    workspace.coords.assign(points);
+    if (!centerInside)
+        internal::initConflictGraph(workspace, convexHull, points, 0);
+    else if (!internal::initLocatedConflictGraph(workspace, convexHull, points, located, 8 * (convexHull.numberFaces() + nPoints))){
+        //the batch sees a large part of the hull: its hull is recomputed from scratch
+        for (const Dcel::Vertex* v : convexHull.vertexIterator())
+            points.push_back(v->coordinate());
+        convexHull.clear();
+        internal::randomizedIncrementalConvexHull(convexHull, points, workspace);
+        updateHull();
+        return;
+    }
+
+    newFaces.clear();
+    for (unsigned int i = 0; i < nPoints; i++){
+        if (internal::insertPoint(convexHull, workspace, points, i)){
+            for (const Dcel::Face* f : workspace.newFaces)
+                newFaces.push_back(f->id());
+        }
+    }
+    if (!centerInside || convexHull.numberVertices() >= 2 * ballVertices)
+        updateHull();
+    else
+        updateNewFaces();
+}
+
+/**
+ * @brief ConvexHullBuilder::updateHull
+ * Updates normals and bounding box of the hull, and the ball used to locate the points: the
+ * center is the centroid of the vertices, and the radius its distance from the nearest face
+ * plane, slightly reduced to be safe against rounding errors. If rounding brings the centroid
+ * on the boundary of a very thin hull, the walks are not used.
+ */
+inline void ConvexHullBuilder::updateHull()
+{
+    convexHull.updateFaceNormals();
+    convexHull.updateVertexNormals();
+    convexHull.updateBoundingBox();
+    innerSquaredRadius = 0;
+    centerInside = false;
+    ballVertices = convexHull.numberVertices();
+    if (coplanar)
+        return;
+
+    innerCenter = Pointd();
+    for (const Dcel::Vertex* v : convexHull.vertexIterator())
+        innerCenter += v->coordinate();
+    innerCenter /= convexHull.numberVertices();
+
+    double radius = std::numeric_limits<double>::max();
+    centerInside = true;
+    for (const Dcel::Face* f : convexHull.faceIterator()){
+        const Pointd& a = f->outerHalfEdge()->fromVertex()->coordinate();
+        radius = std::min(radius, std::fabs((innerCenter - a).dot(f->normal())));
+        if (internal::isFaceVisible(f, innerCenter))
+            centerInside = false;
+    }
+    radius *= 1 - 1e-6;
+    if (centerInside)
+        innerSquaredRadius = radius * radius;
+}
+
+/**
+ * @brief ConvexHullBuilder::updateNewFaces
+ * Updates the normals of the faces created by the last batch and of their vertices, and the
+ * bounding box of the hull. The ball used to locate the points is kept: it was inside the
+ * previous hull, which is contained in the current one.
+ */
+inline void ConvexHullBuilder::updateNewFaces()
+{
+    for (unsigned int fid : newFaces){
+        Dcel::Face* f = convexHull.face(fid);
+        if (f != nullptr)
+            f->updateArea();
+    }
+    workspace.startInsertion();
+    for (unsigned int fid : newFaces){
+        Dcel::Face* f = convexHull.face(fid);
+        if (f != nullptr){
+            for (Dcel::Vertex* v : f->incidentVertexIterator()){
+                if (workspace.markVertex(v))
+                    v->updateNormal();
+            }
+        }
+    }
+    convexHull.updateBoundingBox();
+}
+
+} //namespace cg3
@@ -0,0 +1,82 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_CACHE_H
+#define CG3_CONVEXHULL_CACHE_H
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include "convexhull.h"
+
+namespace cg3 {
+
+/**
+ * @brief The ConvexHullCache class stores the computed hulls in a directory, so that the hull
+ * of an input that has already been processed (also by another run of the program) is loaded
+ * instead of being recomputed.
+ *
+ * Every entry is a file whose name is the hash of the input coordinates and of the options
+ * that change the output (algorithm, extreme points filter and insertion order). The file
+ * contains the number of input points and a checksum of their coordinates, used to detect hash
+ * collisions, followed by the hull vertices (three doubles each) and triangles (three indices
+ * each). A hit memory-maps the entry and builds the Dcel from it.
+ *
+ * The total size of the entries is kept below a limit by removing the least recently used
+ * ones; the last use of an entry is the modification time of its file, hence it is shared by
+ * all the programs that use the same directory. The directory must exist.
+ */
+class ConvexHullCache
+{
+public:
+    ConvexHullCache(const std::string& directory, unsigned long long maxBytes = 1ULL << 30);
+
+    template <class InputContainer>
+    Dcel convexHull(
+            const InputContainer& points,
+            const ConvexHullOptions& options = ConvexHullOptions(),
+            ConvexHullStatistics* statistics = nullptr);
+
+    unsigned long long numberHits() const;
+    unsigned long long numberMisses() const;
+    unsigned long long numberEvictions() const;
+    unsigned long long numberEntries() const;
+    unsigned long long size() const;
+    void resetStatistics();
+
+    void clear();
+
+protected:
+    struct Entry {
+        std::string name;
+        unsigned long long bytes;
+    };
+
+    std::string entryPath(const std::string& name) const;
+    bool load(const std::string& name, unsigned long long nPoints, unsigned long long checksum, Dcel& convexHull);
+    void store(const std::string& name, unsigned long long nPoints, unsigned long long checksum, const Dcel& convexHull);
+    void touch(std::list<Entry>::iterator entry);
+    void remove(std::list<Entry>::iterator entry);
+    void evict();
+
+    std::string directory;
+    unsigned long long maxBytes;
+    unsigned long long totalBytes;
+
+    std::list<Entry> entries; //from the most to the least recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> entryMap;
+
+    unsigned long long nHits;
+    unsigned long long nMisses;
+    unsigned long long nEvictions;
+};
+
+} //namespace cg3
+
+#include "convexhull_cache.tpp"
+
+#endif // CG3_CONVEXHULL_CACHE_H
@@ -0,0 +1,414 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull_cache.h"
+#include <utilities/hash.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+namespace cg3 {
+
+namespace internal {
+
+static const unsigned long long hullCacheMagic = 0x314c4c5548334743ULL; //"CG3HULL1"
+static const unsigned long long hullCacheHeaderSize = 5 * sizeof(unsigned long long);
+
+/**
+ * @brief A file of the cache directory, found when the cache is opened.
+ */
+struct HullCacheFile {
+    std::string name;
+    unsigned long long bytes;
+    long long lastUse;
+};
+
+/**
+ * @brief Appends to files the entries (files with extension ".hull") of directory.
+ */
+inline void listHullCacheFiles(const std::string& directory, std::vector<HullCacheFile>& files)
+{
+    #ifdef _WIN32
+    struct _finddata64_t data;
+    intptr_t handle = _findfirst64((directory + "/*.hull").c_str(), &data);
+    if (handle == -1)
+        return;
+    do {
+        files.push_back({data.name, (unsigned long long)data.size, (long long)data.time_write});
+    } while (_findnext64(handle, &data) == 0);
+    _findclose(handle);
+    #else
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        return;
+    while (struct dirent* e = readdir(dir)){
+        std::string name = e->d_name;
+        struct stat st;
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".hull") == 0 &&
+                stat((directory + "/" + name).c_str(), &st) == 0)
+            files.push_back({name, (unsigned long long)st.st_size, (long long)st.st_mtime});
+    }
+    closedir(dir);
+    #endif
+}
+
+} //namespace cg3::internal
+
+/**
+ * @brief ConvexHullCache::ConvexHullCache
+ * Opens the cache stored in directory, removing the least recently used entries if their size
+ * exceeds maxBytes.
+ * @param[in] directory: an existing directory
+ * @param[in] maxBytes: maximum total size of the entries
+ */
+inline ConvexHullCache::ConvexHullCache(const std::string& directory, unsigned long long maxBytes) :
+    directory(directory),
+    maxBytes(maxBytes),
+    totalBytes(0),
+    nHits(0),
+    nMisses(0),
+    nEvictions(0)
+{
+    std::vector<internal::HullCacheFile> files;
+    internal::listHullCacheFiles(directory, files);
+    std::sort(files.begin(), files.end(), [](const internal::HullCacheFile& a, const internal::HullCacheFile& b){
+        return a.lastUse > b.lastUse;
+    });
+    for (const internal::HullCacheFile& f : files){
+        entries.push_back({f.name, f.bytes});
+        entryMap[f.name] = std::prev(entries.end());
+        totalBytes += f.bytes;
+    }
+    evict();
+}
+
+/**
+ * @brief ConvexHullCache::convexHull
+ * Returns the convex hull of points: if the cache contains the hull of the same points computed
+ * with the same options it is loaded, otherwise it is computed with cg3::convexHull and stored
+ * in the cache (unless the computation has been cancelled). Approximate hulls (options.epsilon
+ * or options.maxVertices not 0) are always computed, since their error bound is not stored.
+ * @param[in] points: any container of Pointd with begin() and end()
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation
+ * (only the number of input points on a hit)
+ * @return the convex hull, a triangle mesh
+ */
+template <class InputContainer>
+Dcel ConvexHullCache::convexHull(const InputContainer& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    if (options.epsilon > 0 || options.maxVertices > 0)
+        return cg3::convexHull(points, options, statistics);
+
+    //the key is used as name of the entry, the checksum detects the collisions
+    std::size_t key = 0;
+    unsigned long long checksum = 14695981039346656037ULL;
+    unsigned long long nPoints = 0;
+    for (const Pointd& p : points){
+        hashCombine(key, p);
+        for (unsigned int i = 0; i < 3; i++){
+            unsigned long long bits;
+            double c = p[i];
+            std::memcpy(&bits, &c, sizeof(bits));
+            checksum = (checksum ^ bits) * 1099511628211ULL;
+        }
+        nPoints++;
+    }
+    hashCombine(key, nPoints, (int)options.algorithm, options.extremePointsFilter, (int)options.insertionOrder);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.hull", (unsigned long long)key);
+
+    Dcel hull;
+    if (load(name, nPoints, checksum, hull)){
+        nHits++;
+        if (statistics != nullptr){
+            *statistics = ConvexHullStatistics();
+            statistics->nInputPoints = nPoints;
+        }
+        return hull;
+    }
+
+    nMisses++;
+    ConvexHullStatistics localStatistics;
+    if (statistics == nullptr)
+        statistics = &localStatistics;
+    Dcel computedHull = cg3::convexHull(points, options, statistics);
+    if (!statistics->cancelled)
+        store(name, nPoints, checksum, computedHull);
+    return computedHull;
+}
+
+/**
+ * @brief ConvexHullCache::numberHits
+ * @return the number of hulls loaded from the cache since the creation (or the last
+ * resetStatistics)
+ */
+inline unsigned long long ConvexHullCache::numberHits() const
+{
+    return nHits;
+}
+
+/**
+ * @brief ConvexHullCache::numberMisses
+ * @return the number of hulls computed since the creation (or the last resetStatistics)
+ */
+inline unsigned long long ConvexHullCache::numberMisses() const
+{
+    return nMisses;
+}
+
+/**
+ * @brief ConvexHullCache::numberEvictions
+ * @return the number of entries removed to respect the size limit since the creation (or the
+ * last resetStatistics)
+ */
+inline unsigned long long ConvexHullCache::numberEvictions() const
+{
+    return nEvictions;
+}
+
+/**
+ * @brief ConvexHullCache::numberEntries
+ * @return the number of hulls stored in the cache
+ */
+inline unsigned long long ConvexHullCache::numberEntries() const
+{
+    return entries.size();
+}
+
+/**
+ * @brief ConvexHullCache::size
+ * @return the total size (in bytes) of the entries
+ */
+inline unsigned long long ConvexHullCache::size() const
+{
+    return totalBytes;
+}
+
+inline void ConvexHullCache::resetStatistics()
+{
+    nHits = 0;
+    nMisses = 0;
+    nEvictions = 0;
+}
+
+/**
+ * @brief ConvexHullCache::clear
+ * Removes all the entries of the cache.
+ */
+inline void ConvexHullCache::clear()
+{
+    while (!entries.empty())
+        remove(entries.begin());
+}
+
+inline std::string ConvexHullCache::entryPath(const std::string& name) const
+{
+    return directory + "/" + name;
+}
+
+/**
+ * @brief ConvexHullCache::load
+ * Builds convexHull from the entry name, if it exists and it contains the hull of nPoints
+ * points with the given checksum. The entry becomes the most recently used.
+ * @return true if the hull has been loaded
+ */
+inline bool ConvexHullCache::load(const std::string& name, unsigned long long nPoints, unsigned long long checksum, Dcel& convexHull)
+{
+    //the entry could have been added or removed by another program that uses the directory
+    std::string path = entryPath(name);
+    unsigned long long bytes = 0;
+    #ifdef _WIN32
+    std::vector<char> buffer;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (file.is_open()){
+        bytes = (unsigned long long)file.tellg();
+        buffer.resize(bytes);
+        file.seekg(0);
+        file.read(buffer.data(), bytes);
+    }
+    const char* data = buffer.data();
+    #else
+    const char* data = nullptr;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0){
+        bytes = (unsigned long long)st.st_size;
+        void* map = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        data = map == MAP_FAILED ? nullptr : (const char*)map;
+    }
+    if (fd >= 0)
+        ::close(fd);
+    if (data == nullptr)
+        bytes = 0;
+    #endif
+
+    bool valid = false;
+    if (bytes >= internal::hullCacheHeaderSize){
+        unsigned long long header[5];
+        std::memcpy(header, data, sizeof(header));
+        unsigned long long nVertices = header[3], nTriangles = header[4];
+        valid = header[0] == internal::hullCacheMagic && header[1] == nPoints && header[2] == checksum &&
+                bytes == internal::hullCacheHeaderSize + nVertices * sizeof(double[3]) + nTriangles * sizeof(unsigned int[3]);
+        if (valid){
+            const char* p = data + internal::hullCacheHeaderSize;
+            std::vector<Dcel::Vertex*> vertices(nVertices);
+            for (unsigned long long i = 0; i < nVertices; i++, p += sizeof(double[3])){
+                double c[3];
+                std::memcpy(c, p, sizeof(c));
+                vertices[i] = convexHull.addVertex(Pointd(c[0], c[1], c[2]));
+            }
+            std::vector<unsigned int> triangles(3 * nTriangles);
+            if (nTriangles > 0)
+                std::memcpy(triangles.data(), p, triangles.size() * sizeof(unsigned int));
+            internal::insertTriangles(convexHull, vertices, triangles);
+            convexHull.updateFaceNormals();
+            convexHull.updateVertexNormals();
+            convexHull.updateBoundingBox();
+        }
+    }
+    #ifndef _WIN32
+    if (data != nullptr)
+        munmap((void*)data, bytes);
+    #endif
+
+    auto it = entryMap.find(name);
+    if (!valid){
+        if (bytes == 0 && it != entryMap.end()){ //the file does not exist anymore
+            totalBytes -= it->second->bytes;
+            entries.erase(it->second);
+            entryMap.erase(it);
+        }
+        return false;
+    }
+    if (it == entryMap.end()){
+        entries.push_front({name, bytes});
+        it = entryMap.insert(std::make_pair(name, entries.begin())).first;
+        totalBytes += bytes;
+    }
+    touch(it->second);
+    return true;
+}
+
+/**
+ * @brief ConvexHullCache::store
+ * Writes convexHull in the entry name (replacing the previous content), which becomes the most
+ * recently used, and removes the least recently used entries if the cache is too large.
+ * An entry larger than the size limit of the cache is not stored.
+ * The file is written with a temporary name and then renamed, hence other programs that use
+ * the directory never read a partial entry.
+ */
+inline void ConvexHullCache::store(const std::string& name, unsigned long long nPoints, unsigned long long checksum, const Dcel& convexHull)
+{
+    std::unordered_map<unsigned int, unsigned int> vertexIndex;
+    std::vector<double> coords;
+    coords.reserve(3 * convexHull.numberVertices());
+    for (const Dcel::Vertex* v : convexHull.vertexIterator()){
+        vertexIndex[v->id()] = (unsigned int)vertexIndex.size();
+        for (unsigned int i = 0; i < 3; i++)
+            coords.push_back(v->coordinate()[i]);
+    }
+    std::vector<unsigned int> triangles;
+    triangles.reserve(3 * convexHull.numberFaces());
+    for (const Dcel::Face* f : convexHull.faceIterator()){
+        const Dcel::HalfEdge* e = f->outerHalfEdge();
+        triangles.push_back(vertexIndex[e->fromVertex()->id()]);
+        triangles.push_back(vertexIndex[e->toVertex()->id()]);
+        triangles.push_back(vertexIndex[e->next()->toVertex()->id()]);
+    }
+    unsigned long long header[5] = {internal::hullCacheMagic, nPoints, checksum, coords.size() / 3, triangles.size() / 3};
+    unsigned long long bytes = sizeof(header) + coords.size() * sizeof(double) + triangles.size() * sizeof(unsigned int);
+    if (bytes > maxBytes)
+        return; //it would be evicted immediately
+
+    std::string path = entryPath(name);
+    std::string tmpPath = path + "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        file.write((const char*)header, sizeof(header));
+        file.write((const char*)coords.data(), coords.size() * sizeof(double));
+        file.write((const char*)triangles.data(), triangles.size() * sizeof(unsigned int));
+        if (!file.good()){
+            file.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    #ifdef _WIN32
+    std::remove(path.c_str()); //rename does not replace an existing file
+    #endif
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0){
+        std::remove(tmpPath.c_str());
+        return;
+    }
+
+    auto it = entryMap.find(name);
+    if (it != entryMap.end()){
+        totalBytes -= it->second->bytes;
+        entries.erase(it->second);
+    }
+    Entry entry = {name, bytes};
+    entries.push_front(entry);
+    entryMap[name] = entries.begin();
+    totalBytes += entry.bytes;
+    evict();
+}
+
+/**
+ * @brief ConvexHullCache::touch
+ * Makes entry the most recently used, also for the other programs that use the directory.
+ */
+inline void ConvexHullCache::touch(std::list<Entry>::iterator entry)
+{
+    entries.splice(entries.begin(), entries, entry);
+    #ifdef _WIN32
+    _utime(entryPath(entry->name).c_str(), nullptr);
+    #else
+    utime(entryPath(entry->name).c_str(), nullptr);
+    #endif
+}
+
+/**
+ * @brief ConvexHullCache::remove
+ * Removes entry and its file.
+ */
+inline void ConvexHullCache::remove(std::list<Entry>::iterator entry)
+{
+    std::remove(entryPath(entry->name).c_str());
+    totalBytes -= entry->bytes;
+    entryMap.erase(entry->name);
+    entries.erase(entry);
+}
+
+/**
+ * @brief ConvexHullCache::evict
+ * Removes the least recently used entries until the cache respects the size limit.
+ */
+inline void ConvexHullCache::evict()
+{
+    while (totalBytes > maxBytes && !entries.empty()){
+        remove(std::prev(entries.end()));
+        nEvictions++;
+    }
+}
+
+} //namespace cg3
@@ -0,0 +1,63 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_CONTROL_H
+#define CG3_CONVEXHULL_CONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace cg3 {
+
+/**
+ * @brief Called by the hull engines with the number of input points already processed (inserted
+ * in the hull or discarded) and the total number of points.
+ */
+typedef std::function<void(unsigned long long nProcessedPoints, unsigned long long nPoints)> ConvexHullProgressCallback;
+
+namespace internal {
+
+/**
+ * @brief The ConvexHullControl class is polled by the loops of the hull engines: it checks the
+ * cancellation token and the deadline, and every pollInterval processed points it reports the
+ * progress. Once the computation must stop, it stays stopped and every poll returns true
+ * without calling the progress callback.
+ */
+class ConvexHullControl
+{
+public:
+    ConvexHullControl(
+            const ConvexHullProgressCallback& progress,
+            std::chrono::steady_clock::time_point deadline,
+            const std::atomic<bool>* cancel,
+            unsigned int nPoints);
+
+    bool poll(unsigned int nProcessedPoints);
+    bool mustStop();
+    bool isStopped() const;
+    void finish();
+
+    ConvexHullControl withoutProgress() const;
+
+    static const unsigned int pollInterval = 1024;
+
+protected:
+    const ConvexHullProgressCallback& progress;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* cancel;
+    unsigned int nPoints;
+    unsigned int nextPoll;
+    bool stopped;
+};
+
+} //namespace cg3::internal
+} //namespace cg3
+
+#include "convexhull_control.tpp"
+
+#endif // CG3_CONVEXHULL_CONTROL_H
@@ -0,0 +1,100 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull_control.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief ConvexHullControl::ConvexHullControl
+ * @param[in] progress: callback of the progress (it can be empty), that must outlive the control
+ * @param[in] deadline: the computation must stop after this time point
+ * @param[in] cancel: the computation must stop when it becomes true (nullptr: no token)
+ * @param[in] nPoints: total number of points of the computation
+ */
+inline ConvexHullControl::ConvexHullControl(
+        const ConvexHullProgressCallback& progress,
+        std::chrono::steady_clock::time_point deadline,
+        const std::atomic<bool>* cancel,
+        unsigned int nPoints) :
+    progress(progress),
+    deadline(deadline),
+    cancel(cancel),
+    nPoints(nPoints),
+    nextPoll(pollInterval),
+    stopped(false)
+{
+}
+
+/**
+ * @brief ConvexHullControl::poll
+ * Called by the engines every time that some points have been processed. The stop conditions
+ * are checked at every call, since the first insertions can be very slow (they split the
+ * largest conflict lists), while the progress is reported once every pollInterval points.
+ * @param[in] nProcessedPoints: number of points inserted in the hull or discarded so far
+ * @return true if the computation must stop
+ */
+inline bool ConvexHullControl::poll(unsigned int nProcessedPoints)
+{
+    if (mustStop())
+        return true;
+    if (nProcessedPoints >= nextPoll){
+        nextPoll = nProcessedPoints + pollInterval;
+        if (progress)
+            progress(nProcessedPoints, nPoints);
+    }
+    return false;
+}
+
+/**
+ * @brief ConvexHullControl::mustStop
+ * Checks the cancellation token and the deadline.
+ * @return true if the computation must stop
+ */
+inline bool ConvexHullControl::mustStop()
+{
+    if (!stopped){
+        stopped = (cancel != nullptr && cancel->load(std::memory_order_relaxed)) ||
+                std::chrono::steady_clock::now() > deadline;
+    }
+    return stopped;
+}
+
+/**
+ * @brief ConvexHullControl::isStopped
+ * @return true if a poll has stopped the computation
+ */
+inline bool ConvexHullControl::isStopped() const
+{
+    return stopped;
+}
+
+/**
+ * @brief ConvexHullControl::withoutProgress
+ * Returns a control with the same cancellation token and deadline, which does not report the
+ * progress: it can be polled by a worker thread while this control is polled by the calling
+ * thread, since the two do not share any state.
+ */
+inline ConvexHullControl ConvexHullControl::withoutProgress() const
+{
+    static const ConvexHullProgressCallback noProgress;
+    return ConvexHullControl(noProgress, deadline, cancel, nPoints);
+}
+
+/**
+ * @brief ConvexHullControl::finish
+ * Reports that all the points have been processed (if the computation has not been stopped).
+ */
+inline void ConvexHullControl::finish()
+{
+    if (!stopped && progress)
+        progress(nPoints, nPoints);
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,85 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_WORKSPACE_H
+#define CG3_CONVEXHULL_WORKSPACE_H
+
+#include <algorithm>
+#include <random>
+#include "dcel/dcel.h"
+#include "conflict_graph.h"
+#include "face_planes.h"
+#include "instrumentation.h"
+
+namespace cg3 {
+
+/**
+ * @brief The ConvexHullWorkspace class owns all the memory used by the randomized incremental
+ * algorithm: the conflict graph, the face planes and the buffers used by every point insertion
+ * (visible faces, horizon, candidate points of the new faces).
+ *
+ * The sets of faces and vertices touched by an insertion are flat vectors, and their membership
+ * is given by epoch marks indexed by the Dcel ids: starting a new insertion only increments the
+ * epoch. Since the buffers are never shrunk, once they reach the size required by the input the
+ * insertions do not allocate memory in the workspace, and the same workspace can be reused for
+ * the computation of other hulls (see ConvexHullOptions::workspace).
+ *
+ * The workspace counts the allocations of its buffers (the memory of the conflict graph and of
+ * the Dcel elements is not included), so that numberAllocations() / numberInsertedPoints() is
+ * the number of allocations per inserted point. A workspace must not be used by two threads at
+ * the same time.
+ */
+class ConvexHullWorkspace
+{
+public:
+    ConvexHullWorkspace();
+
+    void clear();
+
+    unsigned long long numberAllocations() const;
+    unsigned long long numberInsertedPoints() const;
+    void resetCounters();
+
+    /* used by the randomized incremental algorithm */
+
+    void startInsertion();
+    void addVisibleFace(Dcel::Face* f);
+    bool isVisible(const Dcel::Face* f) const;
+    bool markVertex(const Dcel::Vertex* v);
+    bool isMarked(const Dcel::Vertex* v) const;
+    template <class T>
+    void push(std::vector<T>& buffer, const T& value);
+    void countAllocation(std::size_t oldCapacity, std::size_t newCapacity);
+    void countInsertedPoint();
+
+    internal::ConflictGraph cg;
+    internal::FacePlanes planes;
+    internal::PointCoordinates coords;
+    std::vector<Dcel::Face*> visibleFaces;
+    std::vector<Dcel::Face*> stack;
+    std::vector<Dcel::HalfEdge*> horizonEdges;
+    std::vector<Dcel::Vertex*> deletedVertices;
+    std::vector<std::vector<unsigned int> > P; //candidate points of every new face
+    std::vector<Dcel::Face*> newFaces;
+    std::vector<signed char> sides;
+    std::mt19937 rng;
+    ConvexHullCounters counters; //counters of the last hull (see CG3_CONVEXHULL_INSTRUMENTATION)
+
+protected:
+    std::vector<unsigned int> faceMarks; //faceMarks[fid] == epoch: the face is visible
+    std::vector<unsigned int> vertexMarks; //vertexMarks[vid] == epoch: the vertex is marked
+    unsigned int epoch;
+
+    unsigned long long nAllocations;
+    unsigned long long nInsertedPoints;
+};
+
+} //namespace cg3
+
+#include "convexhull_workspace.tpp"
+
+#endif // CG3_CONVEXHULL_WORKSPACE_H
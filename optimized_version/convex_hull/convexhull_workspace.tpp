@@ -0,0 +1,177 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull_workspace.h"
+
+namespace cg3 {
+
+/**
+ * @brief ConvexHullWorkspace::ConvexHullWorkspace
+ * Default constructor. It creates an empty workspace.
+ */
+inline ConvexHullWorkspace::ConvexHullWorkspace() :
+    epoch(0),
+    nAllocations(0),
+    nInsertedPoints(0)
+{
+}
+
+/**
+ * @brief ConvexHullWorkspace::clear
+ * Releases all the memory of the workspace. The counters are not changed.
+ */
+inline void ConvexHullWorkspace::clear()
+{
+    cg = internal::ConflictGraph();
+    planes = internal::FacePlanes();
+    coords = internal::PointCoordinates();
+    std::vector<Dcel::Face*>().swap(visibleFaces);
+    std::vector<Dcel::Face*>().swap(stack);
+    std::vector<Dcel::HalfEdge*>().swap(horizonEdges);
+    std::vector<Dcel::Vertex*>().swap(deletedVertices);
+    std::vector<std::vector<unsigned int> >().swap(P);
+    std::vector<Dcel::Face*>().swap(newFaces);
+    std::vector<signed char>().swap(sides);
+    std::vector<unsigned int>().swap(faceMarks);
+    std::vector<unsigned int>().swap(vertexMarks);
+    epoch = 0;
+}
+
+/**
+ * @brief ConvexHullWorkspace::numberAllocations
+ * @return the number of times a buffer of the workspace has been (re)allocated
+ */
+inline unsigned long long ConvexHullWorkspace::numberAllocations() const
+{
+    return nAllocations;
+}
+
+/**
+ * @brief ConvexHullWorkspace::numberInsertedPoints
+ * @return the number of points inserted in a hull using the workspace
+ */
+inline unsigned long long ConvexHullWorkspace::numberInsertedPoints() const
+{
+    return nInsertedPoints;
+}
+
+/**
+ * @brief ConvexHullWorkspace::resetCounters
+ * Sets to zero the number of allocations and of inserted points.
+ */
+inline void ConvexHullWorkspace::resetCounters()
+{
+    nAllocations = 0;
+    nInsertedPoints = 0;
+}
+
+/**
+ * @brief ConvexHullWorkspace::startInsertion
+ * Starts a new insertion: the buffers of the previous one are cleared (keeping their memory),
+ * and all the faces and vertices are unmarked.
+ */
+inline void ConvexHullWorkspace::startInsertion()
+{
+    visibleFaces.clear();
+    horizonEdges.clear();
+    deletedVertices.clear();
+    epoch++;
+    if (epoch == 0){ //overflow: the old marks could be confused with the new ones
+        std::fill(faceMarks.begin(), faceMarks.end(), 0);
+        std::fill(vertexMarks.begin(), vertexMarks.end(), 0);
+        epoch = 1;
+    }
+}
+
+/**
+ * @brief ConvexHullWorkspace::addVisibleFace
+ * Marks the face f as visible and adds it to visibleFaces.
+ * @param[in] f
+ */
+inline void ConvexHullWorkspace::addVisibleFace(Dcel::Face* f)
+{
+    if (f->id() >= faceMarks.size()){
+        std::size_t capacity = faceMarks.capacity();
+        faceMarks.resize(std::max((std::size_t)f->id() + 1, 2 * faceMarks.size()), 0);
+        countAllocation(capacity, faceMarks.capacity());
+    }
+    faceMarks[f->id()] = epoch;
+    push(visibleFaces, f);
+}
+
+/**
+ * @brief ConvexHullWorkspace::isVisible
+ * @param[in] f
+ * @return true if f has been added to the visible faces of the current insertion
+ */
+inline bool ConvexHullWorkspace::isVisible(const Dcel::Face* f) const
+{
+    return f->id() < faceMarks.size() && faceMarks[f->id()] == epoch;
+}
+
+/**
+ * @brief ConvexHullWorkspace::markVertex
+ * Marks the vertex v in the current insertion.
+ * @param[in] v
+ * @return true if v was not marked yet
+ */
+inline bool ConvexHullWorkspace::markVertex(const Dcel::Vertex* v)
+{
+    if (v->id() >= vertexMarks.size()){
+        std::size_t capacity = vertexMarks.capacity();
+        vertexMarks.resize(std::max((std::size_t)v->id() + 1, 2 * vertexMarks.size()), 0);
+        countAllocation(capacity, vertexMarks.capacity());
+    }
+    if (vertexMarks[v->id()] == epoch)
+        return false;
+    vertexMarks[v->id()] = epoch;
+    return true;
+}
+
+/**
+ * @brief ConvexHullWorkspace::isMarked
+ * @param[in] v
+ * @return true if v has been marked in the current insertion
+ */
+inline bool ConvexHullWorkspace::isMarked(const Dcel::Vertex* v) const
+{
+    return v->id() < vertexMarks.size() && vertexMarks[v->id()] == epoch;
+}
+
+/**
+ * @brief ConvexHullWorkspace::push
+ * Appends value to buffer, counting the reallocation of the buffer.
+ * @param[in/out] buffer
+ * @param[in] value
+ */
+template <class T>
+void ConvexHullWorkspace::push(std::vector<T>& buffer, const T& value)
+{
+    if (buffer.size() == buffer.capacity())
+        nAllocations++;
+    buffer.push_back(value);
+}
+
+/**
+ * @brief ConvexHullWorkspace::countAllocation
+ * Counts an allocation if the capacity of a buffer has been changed from oldCapacity to
+ * newCapacity.
+ * @param[in] oldCapacity
+ * @param[in] newCapacity
+ */
+inline void ConvexHullWorkspace::countAllocation(std::size_t oldCapacity, std::size_t newCapacity)
+{
+    if (oldCapacity != newCapacity)
+        nAllocations++;
+}
+
+inline void ConvexHullWorkspace::countInsertedPoint()
+{
+    nInsertedPoints++;
+}
+
+} //namespace cg3
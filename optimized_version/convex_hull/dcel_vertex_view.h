@@ -0,0 +1,48 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_DCEL_VERTEX_VIEW_H
+#define CG3_CONVEXHULL_DCEL_VERTEX_VIEW_H
+
+#include "dcel/dcel.h"
+#include "strided_point_view.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief The DcelVertexView class reads in place the vertices of a Dcel as an array of points,
+ * indexed by the ids of the vertices: in NDEBUG builds it reads the contiguous array of the
+ * vertex coordinates of the Dcel, otherwise the coordinates stored in the vertices.
+ *
+ * The slots of the unused ids return the coordinates of the first vertex of the Dcel: they are
+ * duplicates of an input point, hence they cannot change its hull.
+ */
+class DcelVertexView
+{
+public:
+    DcelVertexView(const Dcel& dcel);
+
+    unsigned int size() const;
+    bool isUsed(unsigned int vid) const;
+    Pointd operator[](unsigned int vid) const;
+
+protected:
+    const Dcel& dcel;
+    unsigned int nSlots;
+    unsigned int firstVertex; //replaces the unused slots
+    #ifdef NDEBUG
+    StridedPointView<double> coordinates;
+    #endif
+};
+
+} //namespace cg3::internal
+} //namespace cg3
+
+#include "dcel_vertex_view.tpp"
+
+#endif // CG3_CONVEXHULL_DCEL_VERTEX_VIEW_H
@@ -0,0 +1,67 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "dcel_vertex_view.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief DcelVertexView::DcelVertexView
+ * Creates a view of the vertices of dcel, which must outlive the view and must not change
+ * while it is used.
+ * @param[in] dcel
+ */
+inline DcelVertexView::DcelVertexView(const Dcel& dcel) :
+    dcel(dcel),
+    nSlots(dcel.numberVertices() > 0 ? dcel.numberVertexSlots() : 0),
+    firstVertex(0)
+{
+    while (firstVertex < nSlots && !isUsed(firstVertex))
+        firstVertex++;
+    #ifdef NDEBUG
+    coordinates = StridedPointView<double>(dcel.vertexCoordinateArray().data(), nSlots);
+    #endif
+}
+
+/**
+ * @brief DcelVertexView::size
+ * @return the number of slots of the vertices, used or not
+ */
+inline unsigned int DcelVertexView::size() const
+{
+    return nSlots;
+}
+
+/**
+ * @brief DcelVertexView::isUsed
+ * @param[in] vid
+ * @return true if vid is the id of a vertex of the Dcel
+ */
+inline bool DcelVertexView::isUsed(unsigned int vid) const
+{
+    return dcel.vertex(vid) != nullptr;
+}
+
+/**
+ * @brief DcelVertexView::operator []
+ * @param[in] vid
+ * @return the coordinates of the vertex vid, or of the first vertex if vid is not used
+ */
+inline Pointd DcelVertexView::operator[](unsigned int vid) const
+{
+    if (!isUsed(vid))
+        vid = firstVertex;
+    #ifdef NDEBUG
+    return coordinates[vid];
+    #else
+    return dcel.vertex(vid)->coordinate();
+    #endif
+}
+
+} //namespace cg3::internal
+} //namespace cg3
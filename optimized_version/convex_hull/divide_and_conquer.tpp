@@ -0,0 +1,532 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <utilities/thread_pool.h>
+#include <unordered_set>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Returns true if all the points lie on the same plane (hence they have not a
+ * three dimensional convex hull). Complexity: O(n).
+ */
+inline bool areAllCoplanar(const std::vector<Pointd>& points)
+{
+    unsigned int simplex[4];
+    return findInitialSimplex(points, simplex) < 4;
+}
+
+/**
+ * @brief Splits the range [begin, end) of points in two halves, using as split the median
+ * of the coordinates along the longest side of the bounding box of the range. The points
+ * equal to the median along the axis go all in the same half (if some point differs from
+ * it), so that the two halves are strictly separated along the axis.
+ * @param[out] axis: the axis of the split
+ * @return the index of the first point of the second half
+ */
+inline unsigned int splitBySpatialMedian(std::vector<Pointd>& points, unsigned int begin, unsigned int end, unsigned int& axis)
+{
+    Pointd min = points[begin], max = points[begin];
+    for (unsigned int i = begin+1; i < end; i++){
+        min = min.min(points[i]);
+        max = max.max(points[i]);
+    }
+    Vec3 size = max - min;
+    axis = 0;
+    if (size.y() > size[axis]) axis = 1;
+    if (size.z() > size[axis]) axis = 2;
+    const unsigned int k = axis;
+
+    unsigned int mid = begin + (end - begin) / 2;
+    std::nth_element(
+                points.begin() + begin, points.begin() + mid, points.begin() + end,
+                [k](const Pointd& a, const Pointd& b){
+                    return a[k] < b[k];
+                });
+    const double median = points[mid][k];
+    unsigned int split = std::partition(points.begin() + begin, points.begin() + mid, [k, median](const Pointd& p){
+        return p[k] < median;
+    }) - points.begin();
+    if (split > begin)
+        return split;
+    //the median is the minimum: the points equal to it go in the first half
+    split = std::partition(points.begin() + mid, points.begin() + end, [k, median](const Pointd& p){
+        return p[k] == median;
+    }) - points.begin();
+    return split < end ? split : mid;
+}
+
+/**
+ * @brief A triangle of the band which joins two separated hulls during their merge: a is a
+ * vertex of the left hull, b of the right hull, and w of the hull side (left if onLeft).
+ * chain is the half edge a->w of the left hull (if onLeft) or b->w of the right hull.
+ */
+struct MergeBandTriangle {
+    Dcel::Vertex* a;
+    Dcel::Vertex* b;
+    Dcel::Vertex* w;
+    Dcel::HalfEdge* chain;
+    bool onLeft;
+};
+
+/**
+ * @brief Collects in hidden the faces of hull which are not on the merged hull: the seeds
+ * and the faces reached from them without crossing the half edges of kept (which belong to
+ * faces on the merged hull). If seeds is empty, all the faces are hidden. isHidden marks the
+ * hidden faces by id.
+ * @return false if the flooding reaches a face of kept, i.e. the chain of kept does not
+ * separate the hidden faces
+ */
+inline bool floodHiddenFaces(Dcel& hull, const std::vector<Dcel::Face*>& seeds, const std::unordered_set<const Dcel::HalfEdge*>& kept, std::vector<bool>& isHidden, std::vector<Dcel::Face*>& hidden)
+{
+    isHidden.assign(hull.numberFaceSlots(), false);
+    hidden.clear();
+    if (seeds.empty()){
+        for (Dcel::Face* f : hull.faceIterator()){
+            isHidden[f->id()] = true;
+            hidden.push_back(f);
+        }
+        return true;
+    }
+    std::vector<bool> isKept(hull.numberFaceSlots(), false);
+    for (const Dcel::HalfEdge* e : kept)
+        isKept[e->face()->id()] = true;
+    auto hide = [&](Dcel::Face* f){
+        if (isKept[f->id()])
+            return false;
+        if (!isHidden[f->id()]){
+            isHidden[f->id()] = true;
+            hidden.push_back(f);
+        }
+        return true;
+    };
+    for (Dcel::Face* f : seeds){
+        if (!hide(f))
+            return false;
+    }
+    for (unsigned int i = 0; i < hidden.size(); i++){
+        for (Dcel::HalfEdge* e : hidden[i]->incidentHalfEdgeIterator()){
+            if (kept.count(e->twin()) == 0 && !hide(e->twin()->face()))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Merges in left the hull right, whose vertices have all coordinate axis greater than
+ * the vertices of left (Preparata-Hong): the band of triangles which joins the two hulls is
+ * wrapped around them, starting from a bridge edge found on the projections of the hulls,
+ * then the faces hidden by the band are deleted and the remaining faces of right are moved
+ * in left. Every step of the wrapping looks only at the neighbours of the two vertices of
+ * the current bridge, hence the merge takes time proportional to the number of faces
+ * deleted and moved.
+ *
+ * The wrapping requires that no four vertices on the band are coplanar: if they are (e.g.
+ * for points on a grid), the function fails.
+ * @return false if the hulls cannot be merged: left and right are then left unchanged
+ */
+inline bool mergeSeparatedHulls(Dcel& left, Dcel& right, unsigned int axis)
+{
+    const unsigned int k = axis, j = (axis + 1) % 3;
+    if (left.numberFaces() == 0 || right.numberFaces() == 0)
+        return false;
+    Dcel::Vertex* a = nullptr;
+    for (Dcel::Vertex* v : left.vertexIterator()){
+        if (a == nullptr || v->coordinate()[k] > a->coordinate()[k])
+            a = v;
+    }
+    Dcel::Vertex* b = nullptr;
+    for (Dcel::Vertex* v : right.vertexIterator()){
+        if (b == nullptr || v->coordinate()[k] < b->coordinate()[k])
+            b = v;
+    }
+    if (!(a->coordinate()[k] < b->coordinate()[k]))
+        return false;
+    const unsigned int maxSteps = left.numberVertices() + right.numberVertices() + 3;
+
+    /**
+     * Bridge: upper tangent of the projections of the hulls on the plane (k, j). The vertical
+     * plane which contains it is a supporting plane of both the hulls.
+     */
+    auto isAboveBridge = [&](const Dcel::Vertex* u){
+        const Pointd& pa = a->coordinate(), & pb = b->coordinate(), & pu = u->coordinate();
+        return orient2d(Point2Dd(pa[k], pa[j]), Point2Dd(pb[k], pb[j]), Point2Dd(pu[k], pu[j])) > 0;
+    };
+    unsigned int nSteps = 0;
+    for (bool moved = true; moved; ){
+        moved = false;
+        for (Dcel::HalfEdge* e : a->outgoingHalfEdgeIterator()){
+            if (isAboveBridge(e->toVertex())){
+                a = e->toVertex();
+                moved = true;
+                break;
+            }
+        }
+        for (Dcel::HalfEdge* e : b->outgoingHalfEdgeIterator()){
+            if (isAboveBridge(e->toVertex())){
+                b = e->toVertex();
+                moved = true;
+                break;
+            }
+        }
+        if (++nSteps > maxSteps)
+            return false;
+    }
+
+    /**
+     * The previous triangle of the band (b, a, c) lies on the vertical plane: c is a point
+     * above or below a, chosen such that the hulls are inside the triangle.
+     */
+    Pointd c = a->coordinate();
+    c[(axis + 2) % 3] += std::abs(c[(axis + 2) % 3]) + 1;
+    Pointd below = a->coordinate();
+    below[j] -= std::abs(below[j]) + 1;
+    if (areCoplanar(b->coordinate(), a->coordinate(), c, below) < 0){
+        c = a->coordinate();
+        c[(axis + 2) % 3] -= std::abs(c[(axis + 2) % 3]) + 1;
+    }
+    const Dcel::Vertex* cVertex = nullptr;
+
+    //wrapping
+    Dcel::Vertex* a0 = a, * b0 = b;
+    std::vector<MergeBandTriangle> band;
+    do {
+        if (band.size() > maxSteps)
+            return false;
+        const Pointd pa = a->coordinate(), pb = b->coordinate();
+        Dcel::HalfEdge* best = nullptr;
+        bool bestOnLeft = true, degenerate = false;
+        auto consider = [&](Dcel::HalfEdge* e, bool onLeft){
+            const Dcel::Vertex* u = e->toVertex();
+            if (u == cVertex)
+                return;
+            if (areCoplanar(pb, pa, c, u->coordinate()) <= 0)
+                degenerate = true;
+            else if (best == nullptr){
+                best = e;
+                bestOnLeft = onLeft;
+            }
+            else {
+                double s = areCoplanar(pa, pb, best->toVertex()->coordinate(), u->coordinate());
+                if (s == 0)
+                    degenerate = true;
+                else if (s < 0){
+                    best = e;
+                    bestOnLeft = onLeft;
+                }
+            }
+        };
+        for (Dcel::HalfEdge* e : a->outgoingHalfEdgeIterator())
+            consider(e, true);
+        for (Dcel::HalfEdge* e : b->outgoingHalfEdgeIterator())
+            consider(e, false);
+        if (degenerate || best == nullptr)
+            return false;
+
+        band.push_back({a, b, best->toVertex(), best, bestOnLeft});
+        if (bestOnLeft){
+            c = pa;
+            cVertex = a;
+            a = best->toVertex();
+        }
+        else {
+            c = pb;
+            cVertex = b;
+            b = best->toVertex();
+        }
+    } while (a != a0 || b != b0);
+
+    /**
+     * The chains of the band are closed walks on the two hulls, which can pass twice on an
+     * edge (in opposite directions): both the faces of the edge are then hidden, and the two
+     * triangles of the band on it are glued together (partner).
+     */
+    std::unordered_map<const Dcel::HalfEdge*, unsigned int> chainIndex;
+    for (unsigned int i = 0; i < band.size(); i++){
+        if (!chainIndex.insert(std::make_pair(band[i].chain, i)).second)
+            return false;
+    }
+    std::vector<int> partner(band.size(), -1);
+    std::unordered_set<const Dcel::Vertex*> chainVertices = {a0, b0};
+    std::unordered_set<const Dcel::HalfEdge*> keptLeft, keptRight;
+    std::vector<Dcel::Face*> seedsLeft, seedsRight;
+    for (unsigned int i = 0; i < band.size(); i++){
+        const MergeBandTriangle& t = band[i];
+        std::unordered_map<const Dcel::HalfEdge*, unsigned int>::const_iterator it = chainIndex.find(t.chain->twin());
+        if (it != chainIndex.end())
+            partner[i] = it->second;
+        if (t.onLeft){
+            chainVertices.insert(t.a);
+            if (partner[i] < 0)
+                keptLeft.insert(t.chain);
+            seedsLeft.push_back(t.chain->twin()->face());
+        }
+        else {
+            chainVertices.insert(t.b);
+            if (partner[i] < 0)
+                keptRight.insert(t.chain->twin());
+            seedsRight.push_back(t.chain->face());
+        }
+    }
+    std::vector<bool> isHiddenLeft, isHiddenRight;
+    std::vector<Dcel::Face*> hiddenLeft, hiddenRight;
+    if (!floodHiddenFaces(left, seedsLeft, keptLeft, isHiddenLeft, hiddenLeft) ||
+            !floodHiddenFaces(right, seedsRight, keptRight, isHiddenRight, hiddenRight))
+        return false;
+
+    //deletion of the hidden faces of left
+    std::vector<bool> isHiddenVertex(left.numberVertexSlots(), false);
+    std::vector<Dcel::Vertex*> hiddenVertices;
+    for (Dcel::Face* f : hiddenLeft){
+        for (Dcel::HalfEdge* e : f->incidentHalfEdgeIterator()){
+            Dcel::Vertex* v = e->fromVertex();
+            if (!isHiddenVertex[v->id()] && chainVertices.count(v) == 0){
+                isHiddenVertex[v->id()] = true;
+                hiddenVertices.push_back(v);
+            }
+        }
+    }
+    for (unsigned int i = 0; i < band.size(); i++){
+        if (band[i].onLeft && partner[i] < 0)
+            band[i].chain->setTwin(nullptr);
+    }
+    for (Dcel::Face* f : hiddenLeft){
+        Dcel::HalfEdge* e1 = f->outerHalfEdge();
+        Dcel::HalfEdge* e2 = e1->next();
+        Dcel::HalfEdge* e3 = e2->next();
+        left.deleteHalfEdge(e1);
+        left.deleteHalfEdge(e2);
+        left.deleteHalfEdge(e3);
+        left.deleteFace(f);
+    }
+    for (Dcel::Vertex* v : hiddenVertices)
+        left.deleteVertex(v);
+
+    //copy in left of the faces of right which are not hidden
+    std::vector<Dcel::Vertex*> vertexMap(right.numberVertexSlots(), nullptr);
+    std::vector<Dcel::HalfEdge*> halfEdgeMap(right.numberHalfEdgeSlots(), nullptr);
+    std::vector<Dcel::Face*> faceMap(right.numberFaceSlots(), nullptr);
+    auto copyVertex = [&](const Dcel::Vertex* v){
+        if (vertexMap[v->id()] == nullptr)
+            vertexMap[v->id()] = left.addVertex(v->coordinate());
+    };
+    std::vector<const Dcel::HalfEdge*> keptHalfEdges;
+    for (const Dcel::Face* f : right.faceIterator()){
+        if (isHiddenRight[f->id()])
+            continue;
+        Dcel::Face* nf = left.addFace();
+        nf->setColor(Color(128,128,128));
+        faceMap[f->id()] = nf;
+        for (const Dcel::HalfEdge* e : f->incidentHalfEdgeIterator()){
+            halfEdgeMap[e->id()] = left.addHalfEdge();
+            keptHalfEdges.push_back(e);
+            copyVertex(e->fromVertex());
+        }
+    }
+    for (const MergeBandTriangle& t : band)
+        copyVertex(t.b);
+    for (const Dcel::HalfEdge* e : keptHalfEdges){
+        Dcel::HalfEdge* ne = halfEdgeMap[e->id()];
+        ne->setFromVertex(vertexMap[e->fromVertex()->id()]);
+        ne->setToVertex(vertexMap[e->toVertex()->id()]);
+        ne->setNext(halfEdgeMap[e->next()->id()]);
+        ne->setPrev(halfEdgeMap[e->prev()->id()]);
+        ne->setFace(faceMap[e->face()->id()]);
+        if (keptRight.count(e) == 0)
+            ne->setTwin(halfEdgeMap[e->twin()->id()]);
+        ne->fromVertex()->setIncidentHalfEdge(ne);
+        if (e->face()->outerHalfEdge() == e)
+            ne->face()->setOuterHalfEdge(ne);
+    }
+
+    //band: every triangle is glued to the previous one and to its chain edge
+    Dcel::HalfEdge* first = nullptr, * pending = nullptr;
+    std::vector<Dcel::HalfEdge*> chainEdges(band.size());
+    for (unsigned int i = 0; i < band.size(); i++){
+        const MergeBandTriangle& t = band[i];
+        Dcel::Vertex* va = t.a, * vb = vertexMap[t.b->id()], * vw = t.onLeft ? t.w : vertexMap[t.w->id()];
+        Dcel::HalfEdge* e1 = left.addHalfEdge(), * e2 = left.addHalfEdge(), * e3 = left.addHalfEdge();
+        Dcel::Face* f = left.addFace();
+        f->setOuterHalfEdge(e1);
+        f->setColor(Color(128,128,128));
+        Dcel::Vertex* vs[3] = {va, vb, vw};
+        Dcel::HalfEdge* es[3] = {e1, e2, e3};
+        for (unsigned int h = 0; h < 3; h++){
+            es[h]->setFromVertex(vs[h]);
+            es[h]->setToVertex(vs[(h+1)%3]);
+            es[h]->setNext(es[(h+1)%3]);
+            es[h]->setPrev(es[(h+2)%3]);
+            es[h]->setFace(f);
+            vs[h]->setIncidentHalfEdge(es[h]);
+        }
+        //e1 = a->b, twin of the previous triangle
+        if (pending == nullptr)
+            first = e1;
+        else {
+            e1->setTwin(pending);
+            pending->setTwin(e1);
+        }
+        //chain edge: w->a on left, b->w on right
+        chainEdges[i] = t.onLeft ? e3 : e2;
+        if (partner[i] < 0){
+            Dcel::HalfEdge* keptEdge = t.onLeft ? t.chain : halfEdgeMap[t.chain->twin()->id()];
+            chainEdges[i]->setTwin(keptEdge);
+            keptEdge->setTwin(chainEdges[i]);
+        }
+        pending = t.onLeft ? e2 : e3;
+    }
+    first->setTwin(pending);
+    pending->setTwin(first);
+    for (unsigned int i = 0; i < band.size(); i++){
+        if (partner[i] >= 0)
+            chainEdges[i]->setTwin(chainEdges[partner[i]]);
+    }
+
+    right.clear();
+    return true;
+}
+
+/**
+ * @brief A cell of the divide and conquer: the hull of its points, or the points themselves
+ * if they have not a three dimensional hull (hull is then empty).
+ */
+struct DivideAndConquerCell {
+    Dcel hull;
+    std::vector<Pointd> flatPoints;
+};
+
+/**
+ * @brief Computes the hull of the points of a cell. The cells are computed in parallel, then
+ * the randomized incremental algorithm polls its own copy of control (if not nullptr), which
+ * stops with it but does not report the progress.
+ */
+inline void computeCellHull(DivideAndConquerCell& cell, std::vector<Pointd>& points, const ConvexHullControl* control)
+{
+    if (points.size() < 4 || areAllCoplanar(points))
+        cell.flatPoints.swap(points);
+    else if (control == nullptr)
+        randomizedIncrementalConvexHull(cell.hull, points);
+    else {
+        ConvexHullControl cellControl = control->withoutProgress();
+        ConvexHullWorkspace workspace;
+        randomizedIncrementalConvexHull(cell.hull, points, workspace, RANDOM_ORDER, 1, &cellControl);
+    }
+}
+
+/**
+ * @brief Merges in left the adjacent cell right, split from left along axis: with
+ * mergeSeparatedHulls if possible, otherwise computing the hull of the union of the hull
+ * vertices (or flat points) of the two cells.
+ */
+inline void mergeCells(DivideAndConquerCell& left, DivideAndConquerCell& right, unsigned int axis, const ConvexHullControl* control)
+{
+    if (left.flatPoints.empty() && right.flatPoints.empty() && mergeSeparatedHulls(left.hull, right.hull, axis))
+        return;
+    std::vector<Pointd> points;
+    points.swap(left.flatPoints);
+    points.insert(points.end(), right.flatPoints.begin(), right.flatPoints.end());
+    for (const Dcel::Vertex* v : left.hull.vertexIterator())
+        points.push_back(v->coordinate());
+    for (const Dcel::Vertex* v : right.hull.vertexIterator())
+        points.push_back(v->coordinate());
+    left.hull.clear();
+    right.hull.clear();
+    right.flatPoints.clear();
+    computeCellHull(left, points, control);
+}
+
+/**
+ * @brief Parallel divide and conquer convex hull: inserts in convexHull the hull of points.
+ *
+ * The points are recursively split by spatial median in a number of cells which is
+ * proportional to the number of threads, and the hulls of all the cells are computed in
+ * parallel using a work-stealing thread pool. Then, sibling cells are merged pairwise, again
+ * in parallel, by wrapping the band of faces which joins their hulls (see
+ * mergeSeparatedHulls): a merge does not recompute the hulls, it only deletes the faces
+ * hidden by the band and moves the others. If the band is degenerate (coplanar vertices, as
+ * on a grid), the merge computes instead the hull of the union of the hull vertices of the
+ * two cells, which is slower when the hulls are large.
+ *
+ * With a single thread the points are not split, and the hull is computed by the serial
+ * randomized incremental algorithm.
+ *
+ * @param[out] convexHull
+ * @param[in] points: the input points, which are reordered by the function
+ * @param[in] nThreads: number of threads; if 0, the number of hardware threads is used
+ * @param[in] control: if not nullptr, the hulls of the cells (and of the unions computed by the
+ * merges) stop with it, and it is checked between the cells, between the merges and between
+ * the levels; the function returns with a partial (or empty) hull when it must stop. The
+ * progress is reported only with a single thread.
+ */
+inline void parallelDivideAndConquerConvexHull(Dcel& convexHull, std::vector<Pointd>& points, unsigned int nThreads, ConvexHullControl* control)
+{
+    const unsigned int minCellSize = 4096;
+    ThreadPool pool(nThreads);
+
+    unsigned int nCells = 1;
+    while (pool.numberThreads() > 1 && nCells < 4 * pool.numberThreads() && points.size() / (2*nCells) >= minCellSize)
+        nCells *= 2;
+
+    if (nCells == 1){
+        ConvexHullWorkspace workspace;
+        randomizedIncrementalConvexHull(convexHull, points, workspace, RANDOM_ORDER, 1, control);
+        return;
+    }
+    //the workers only read control: its state is updated by this thread, between the levels
+    auto mustStop = [control](){
+        return control != nullptr && control->withoutProgress().mustStop();
+    };
+
+    //split: cells[i], cells[i+1] is the range of the i-th cell; axes[l][i] is the axis of
+    //the split between the cells 2i and 2i+1 of the level l (0 is the last split)
+    std::vector<unsigned int> cells = {0, (unsigned int)points.size()};
+    std::vector<std::vector<unsigned int> > axes;
+    while (cells.size() - 1 < nCells){
+        std::vector<unsigned int> newCells(2 * (cells.size() - 1) + 1);
+        std::vector<unsigned int> levelAxes(cells.size() - 1);
+        pool.parallelFor(0, (unsigned int)cells.size() - 1, [&](unsigned int i){
+            newCells[2*i] = cells[i];
+            newCells[2*i+1] = splitBySpatialMedian(points, cells[i], cells[i+1], levelAxes[i]);
+        });
+        newCells.back() = cells.back();
+        cells.swap(newCells);
+        axes.insert(axes.begin(), levelAxes);
+    }
+
+    //hulls of the cells
+    std::vector<DivideAndConquerCell> hulls(nCells);
+    pool.parallelFor(0, nCells, [&](unsigned int i){
+        if (mustStop())
+            return;
+        std::vector<Pointd> cellPoints(points.begin() + cells[i], points.begin() + cells[i+1]);
+        computeCellHull(hulls[i], cellPoints, control);
+    });
+    if (control != nullptr && control->mustStop())
+        return;
+
+    //pairwise merge of sibling cells
+    for (unsigned int level = 0; hulls.size() > 1; level++){
+        std::vector<DivideAndConquerCell> merged(hulls.size() / 2);
+        pool.parallelFor(0, (unsigned int)merged.size(), [&](unsigned int i){
+            if (mustStop())
+                return;
+            mergeCells(hulls[2*i], hulls[2*i+1], axes[level][i], control);
+            merged[i].hull.swap(hulls[2*i].hull);
+            merged[i].flatPoints.swap(hulls[2*i].flatPoints);
+        });
+        if (control != nullptr && control->mustStop())
+            return;
+        hulls.swap(merged);
+    }
+    convexHull.swap(hulls[0].hull);
+}
+
+} //namespace cg3::internal
+} //namespace cg3
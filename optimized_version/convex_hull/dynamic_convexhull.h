@@ -0,0 +1,101 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_DYNAMIC_CONVEXHULL_H
+#define CG3_DYNAMIC_CONVEXHULL_H
+
+#include <unordered_map>
+#include "convexhull.h"
+
+namespace cg3 {
+
+/**
+ * @brief The DynamicConvexHull class keeps the convex hull of a set of points that changes by
+ * insertions and deletions of single points.
+ *
+ * Every point which is not a vertex of the hull is owned by the face crossed by the ray from a
+ * fixed center (strictly inside the hull) through the point. A point is located by walking on
+ * the faces towards its ray, starting from the last updated face:
+ * - inserting a point inside the hull only adds it to the points owned by its face; inserting
+ *   a point outside replaces the faces it sees, as in Quickhull, and the points owned by the
+ *   replaced faces are moved to the new ones, which cover the same rays;
+ * - deleting a point which is not a vertex only removes it from its face; deleting a vertex
+ *   replaces its star with the faces of the hull of its link and of the points owned by the
+ *   star, which are the only ones that can become vertices.
+ *
+ * Hence the cost of an update does not depend on the number of points, but only on the faces
+ * around it. Degenerate inputs are updated locally too: the faces of the new star which contain
+ * the erased point in their plane are kept, and the link vertices aligned with a side of the new
+ * star split it. When the local update cannot be applied (the hull becomes flat, or the center
+ * is not inside the hull anymore) the hull is recomputed from scratch, which happens mostly
+ * when few points become coplanar (see numberRebuilds()).
+ */
+class DynamicConvexHull
+{
+public:
+    DynamicConvexHull();
+    template <class InputContainer>
+    DynamicConvexHull(const InputContainer& points);
+
+    void insert(const Pointd& point);
+    template <class InputContainer>
+    void insert(const InputContainer& points);
+    bool erase(const Pointd& point);
+    void clear();
+
+    const Dcel& hull() const;
+    unsigned int size() const;
+    unsigned int numberRebuilds() const;
+
+protected:
+    unsigned int newPoint(const Pointd& p);
+    void releasePoint(unsigned int pid);
+    void rebuild();
+
+    bool isInFaceCone(const Dcel::Face* f, const Pointd& p) const;
+    Dcel::Face* locate(const Pointd& p, Dcel::Face* start) const;
+    void assign(unsigned int pid, const std::vector<Dcel::Face*>& faces);
+    void addOwned(unsigned int pid, const Dcel::Face* f);
+    void removeOwned(unsigned int pid);
+    void deleteFaces(const std::vector<Dcel::Face*>& faces);
+
+    void insertOutsidePoint(unsigned int pid, Dcel::Face* f);
+    bool eraseHullVertex(unsigned int pid);
+
+    mutable Dcel convexHull;
+    mutable bool changed; //normals and bounding box of the hull must be updated
+    bool fullDimensional; //false if the points are less than four or coplanar
+    Pointd center;
+    Dcel::Face* lastFace; //start of the next walk
+
+    std::vector<Pointd> points; //indexed by point id
+    std::vector<int> owner; //face that owns the point (-1: hull vertex, or released id)
+    std::vector<unsigned int> ownerSlot; //position of the point in the owned points of its face
+    std::vector<Dcel::Vertex*> pointVertex; //vertex of the point (nullptr: not a vertex)
+    std::vector<std::vector<unsigned int> > ownedPoints; //indexed by face id
+    std::vector<unsigned int> vertexPoint; //indexed by vertex id
+    std::vector<unsigned int> freeIds;
+    std::unordered_multimap<Pointd, unsigned int> pointIds;
+    unsigned int nRebuilds;
+
+    std::set<Dcel::Face*> visibleFaces;
+    std::set<Dcel::Vertex*> horizonVertex;
+    std::vector<Dcel::HalfEdge*> horizonEdges;
+    std::vector<Dcel::Face*> stack;
+    std::vector<Dcel::Face*> newFaces;
+    std::vector<unsigned int> orphans; //points of the deleted faces
+
+private:
+    DynamicConvexHull(const DynamicConvexHull&);
+    DynamicConvexHull& operator=(const DynamicConvexHull&);
+};
+
+} //namespace cg3
+
+#include "dynamic_convexhull.tpp"
+
+#endif // CG3_DYNAMIC_CONVEXHULL_H
@@ -0,0 +1,579 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "dynamic_convexhull.h"
+
+namespace cg3 {
+
+/**
+ * @brief DynamicConvexHull::DynamicConvexHull
+ * Default constructor. It creates an empty set of points.
+ */
+inline DynamicConvexHull::DynamicConvexHull() :
+    changed(false),
+    fullDimensional(false),
+    lastFace(nullptr),
+    nRebuilds(0)
+{
+}
+
+/**
+ * @brief DynamicConvexHull::DynamicConvexHull
+ * Creates the hull of points.
+ * @param[in] points: any container of Pointd with begin() and end()
+ */
+template <class InputContainer>
+DynamicConvexHull::DynamicConvexHull(const InputContainer& points) :
+    DynamicConvexHull()
+{
+    insert(points);
+}
+
+/**
+ * @brief DynamicConvexHull::insert
+ * Inserts a point.
+ * @param[in] point
+ */
+inline void DynamicConvexHull::insert(const Pointd& point)
+{
+    unsigned int pid = newPoint(point);
+    changed = true;
+    if (!fullDimensional){
+        rebuild();
+        return;
+    }
+
+    Dcel::Face* f = locate(point, lastFace);
+    //the ray through the point leaves the hull from f: the point is outside iff it sees f
+    if (internal::isFaceStrictlyVisible(f, point))
+        insertOutsidePoint(pid, f);
+    else
+        addOwned(pid, f);
+}
+
+/**
+ * @brief DynamicConvexHull::insert
+ * Inserts a batch of points. If the batch is larger than the current set, the hull is
+ * recomputed from scratch.
+ * @param[in] container: any container of Pointd with begin() and end()
+ */
+template <class InputContainer>
+void DynamicConvexHull::insert(const InputContainer& container)
+{
+    unsigned int n = (unsigned int)std::distance(container.begin(), container.end());
+    if (n > size()){
+        for (const Pointd& p : container)
+            newPoint(p);
+        rebuild();
+    }
+    else {
+        for (const Pointd& p : container)
+            insert(p);
+    }
+}
+
+/**
+ * @brief DynamicConvexHull::erase
+ * Erases a point (one of its copies, if it has been inserted more than once).
+ * @param[in] point
+ * @return false if the point is not in the set
+ */
+inline bool DynamicConvexHull::erase(const Pointd& point)
+{
+    auto range = pointIds.equal_range(point);
+    if (range.first == range.second)
+        return false;
+    //a copy which is not a vertex is erased first: the hull does not change
+    auto it = range.first;
+    for (auto jt = range.first; jt != range.second; ++jt){
+        if (pointVertex[jt->second] == nullptr)
+            it = jt;
+    }
+    unsigned int pid = it->second;
+    pointIds.erase(it);
+    changed = true;
+
+    if (!fullDimensional){
+        releasePoint(pid);
+        rebuild();
+    }
+    else if (pointVertex[pid] == nullptr){
+        removeOwned(pid);
+        releasePoint(pid);
+    }
+    else if (!eraseHullVertex(pid)){
+        releasePoint(pid);
+        rebuild();
+    }
+    else {
+        releasePoint(pid);
+    }
+    return true;
+}
+
+/**
+ * @brief DynamicConvexHull::clear
+ * Erases all the points.
+ */
+inline void DynamicConvexHull::clear()
+{
+    convexHull.clear();
+    changed = false;
+    fullDimensional = false;
+    lastFace = nullptr;
+    points.clear();
+    owner.clear();
+    ownerSlot.clear();
+    pointVertex.clear();
+    ownedPoints.clear();
+    vertexPoint.clear();
+    freeIds.clear();
+    pointIds.clear();
+}
+
+/**
+ * @brief DynamicConvexHull::hull
+ * @return the convex hull of the current points, a triangle mesh (flat if the points are
+ * coplanar), which is valid until the next update
+ */
+inline const Dcel& DynamicConvexHull::hull() const
+{
+    if (changed){
+        convexHull.updateFaceNormals();
+        convexHull.updateVertexNormals();
+        convexHull.updateBoundingBox();
+        changed = false;
+    }
+    return convexHull;
+}
+
+/**
+ * @brief DynamicConvexHull::size
+ * @return the number of points
+ */
+inline unsigned int DynamicConvexHull::size() const
+{
+    return (unsigned int)pointIds.size();
+}
+
+/**
+ * @brief DynamicConvexHull::numberRebuilds
+ * @return the number of times that the hull has been recomputed from scratch
+ */
+inline unsigned int DynamicConvexHull::numberRebuilds() const
+{
+    return nRebuilds;
+}
+
+inline unsigned int DynamicConvexHull::newPoint(const Pointd& p)
+{
+    unsigned int pid;
+    if (!freeIds.empty()){
+        pid = freeIds.back();
+        freeIds.pop_back();
+        points[pid] = p;
+    }
+    else {
+        pid = (unsigned int)points.size();
+        points.push_back(p);
+        owner.push_back(-1);
+        ownerSlot.push_back(0);
+        pointVertex.push_back(nullptr);
+    }
+    pointIds.insert(std::make_pair(p, pid));
+    return pid;
+}
+
+/**
+ * @brief DynamicConvexHull::releasePoint
+ * Makes the id of an erased point available for the next insertions.
+ */
+inline void DynamicConvexHull::releasePoint(unsigned int pid)
+{
+    owner[pid] = -1;
+    pointVertex[pid] = nullptr;
+    freeIds.push_back(pid);
+}
+
+/**
+ * @brief DynamicConvexHull::rebuild
+ * Recomputes the hull of all the points with Quickhull, the center (the centroid of the hull
+ * vertices) and the owners of the points.
+ */
+inline void DynamicConvexHull::rebuild()
+{
+    nRebuilds++;
+    convexHull.clear();
+    changed = true;
+    lastFace = nullptr;
+    for (std::vector<unsigned int>& owned : ownedPoints)
+        owned.clear();
+
+    std::vector<unsigned int> ids;
+    std::vector<Pointd> coords;
+    ids.reserve(pointIds.size());
+    coords.reserve(pointIds.size());
+    for (const std::pair<const Pointd, unsigned int>& p : pointIds){
+        ids.push_back(p.second);
+        coords.push_back(p.first);
+        owner[p.second] = -1;
+        pointVertex[p.second] = nullptr;
+    }
+    fullDimensional = coords.size() >= 4 && !internal::areAllCoplanar(coords);
+
+    std::vector<Pointd> hullPoints(coords);
+    internal::computeConvexHull(convexHull, hullPoints, ConvexHullOptions(QUICKHULL));
+    if (!fullDimensional)
+        return;
+
+    std::unordered_map<Pointd, unsigned int> firstId;
+    for (unsigned int i = 0; i < ids.size(); i++)
+        firstId.insert(std::make_pair(coords[i], ids[i]));
+    center = Pointd();
+    for (Dcel::Vertex* v : convexHull.vertexIterator()){
+        unsigned int pid = firstId[v->coordinate()];
+        pointVertex[pid] = v;
+        if (v->id() >= vertexPoint.size())
+            vertexPoint.resize(v->id() + 1);
+        vertexPoint[v->id()] = pid;
+        center += v->coordinate();
+    }
+    center /= convexHull.numberVertices();
+
+    lastFace = *convexHull.faceIterator().begin();
+    for (unsigned int i = 0; i < ids.size(); i++){
+        if (pointVertex[ids[i]] == nullptr){
+            lastFace = locate(coords[i], lastFace);
+            addOwned(ids[i], lastFace);
+        }
+    }
+}
+
+/**
+ * @brief DynamicConvexHull::isInFaceCone
+ * @return true if the ray from the center through p crosses the face f (or its boundary)
+ */
+inline bool DynamicConvexHull::isInFaceCone(const Dcel::Face* f, const Pointd& p) const
+{
+    return internal::isInFaceCone(f, center, p);
+}
+
+/**
+ * @brief DynamicConvexHull::locate
+ * Visibility walk from the face start to the face crossed by the ray from the center through
+ * p (see internal::locateFace).
+ * @return the face crossed by the ray
+ */
+inline Dcel::Face* DynamicConvexHull::locate(const Pointd& p, Dcel::Face* start) const
+{
+    return internal::locateFace(convexHull, start, center, p);
+}
+
+/**
+ * @brief DynamicConvexHull::assign
+ * Gives the point pid to the face whose cone contains it, searched among faces (the faces that
+ * replaced the previous owner of the point) and then with a walk.
+ */
+inline void DynamicConvexHull::assign(unsigned int pid, const std::vector<Dcel::Face*>& faces)
+{
+    for (Dcel::Face* f : faces){
+        if (isInFaceCone(f, points[pid])){
+            addOwned(pid, f);
+            return;
+        }
+    }
+    addOwned(pid, locate(points[pid], faces[0]));
+}
+
+inline void DynamicConvexHull::addOwned(unsigned int pid, const Dcel::Face* f)
+{
+    if (f->id() >= ownedPoints.size())
+        ownedPoints.resize(f->id() + 1);
+    owner[pid] = f->id();
+    ownerSlot[pid] = (unsigned int)ownedPoints[f->id()].size();
+    ownedPoints[f->id()].push_back(pid);
+}
+
+inline void DynamicConvexHull::removeOwned(unsigned int pid)
+{
+    std::vector<unsigned int>& owned = ownedPoints[owner[pid]];
+    unsigned int last = owned.back();
+    owned[ownerSlot[pid]] = last;
+    ownerSlot[last] = ownerSlot[pid];
+    owned.pop_back();
+    owner[pid] = -1;
+}
+
+/**
+ * @brief DynamicConvexHull::deleteFaces
+ * Deletes faces and their half edges (but not their vertices) from the hull. The points owned
+ * by the faces are moved in orphans.
+ */
+inline void DynamicConvexHull::deleteFaces(const std::vector<Dcel::Face*>& faces)
+{
+    for (Dcel::Face* f : faces){
+        if (f->id() < ownedPoints.size()){
+            for (unsigned int pid : ownedPoints[f->id()]){
+                owner[pid] = -1;
+                orphans.push_back(pid);
+            }
+            ownedPoints[f->id()].clear();
+        }
+
+        Dcel::HalfEdge* e1 = f->outerHalfEdge();
+        Dcel::HalfEdge* e2 = e1->next();
+        Dcel::HalfEdge* e3 = e2->next();
+        convexHull.deleteHalfEdge(e1);
+        convexHull.deleteHalfEdge(e2);
+        convexHull.deleteHalfEdge(e3);
+        convexHull.deleteFace(f);
+    }
+}
+
+/**
+ * @brief DynamicConvexHull::insertOutsidePoint
+ * Inserts the point pid, which sees the face f, as a vertex of the hull: its visible faces are
+ * replaced by the cone from the point to their horizon. The vertices inside the cone and the
+ * points owned by the visible faces are given to the new faces.
+ */
+inline void DynamicConvexHull::insertOutsidePoint(unsigned int pid, Dcel::Face* f)
+{
+    const Pointd& p = points[pid];
+    internal::visibleFacesFlooding(f, p, visibleFaces, stack);
+    horizonEdges.clear();
+    horizonVertex.clear();
+    internal::horizonEdgeList(horizonEdges, visibleFaces, horizonVertex);
+
+    orphans.clear();
+    std::vector<Dcel::Face*> faces(visibleFaces.begin(), visibleFaces.end());
+    std::set<Dcel::Vertex*> innerVertices;
+    for (Dcel::Face* g : faces){
+        for (Dcel::Vertex* v : g->incidentVertexIterator()){
+            if (horizonVertex.find(v) == horizonVertex.end())
+                innerVertices.insert(v);
+        }
+    }
+    deleteFaces(faces);
+    for (Dcel::Vertex* v : innerVertices){
+        unsigned int q = vertexPoint[v->id()];
+        pointVertex[q] = nullptr;
+        orphans.push_back(q);
+        convexHull.deleteVertex(v);
+    }
+
+    internal::insertNewFaces(convexHull, horizonEdges, p, newFaces);
+    Dcel::Vertex* v = newFaces[0]->outerHalfEdge()->next()->toVertex();
+    pointVertex[pid] = v;
+    if (v->id() >= vertexPoint.size())
+        vertexPoint.resize(v->id() + 1);
+    vertexPoint[v->id()] = pid;
+
+    for (unsigned int q : orphans)
+        assign(q, newFaces);
+    lastFace = newFaces[0];
+}
+
+/**
+ * @brief DynamicConvexHull::eraseHullVertex
+ * Erases the vertex of the point pid: its star is replaced by the faces, visible by the point
+ * (or containing it in their plane, and not facing the center), of the hull of its link and of
+ * the points owned by the star; the sides of these faces are split at the link vertices aligned
+ * with them. The replacement is checked before changing the hull: its boundary must be the
+ * link, and the center must be strictly inside its faces.
+ * @return false if the hull must be recomputed (in that case it has not been changed)
+ */
+inline bool DynamicConvexHull::eraseHullVertex(unsigned int pid)
+{
+    Dcel::Vertex* v = pointVertex[pid];
+    const Pointd p = points[pid];
+
+    //star of the vertex, and link: the half edges of the adjacent faces opposite to the vertex
+    std::vector<Dcel::Face*> star;
+    std::vector<Dcel::HalfEdge*> link;
+    Dcel::HalfEdge* e = v->incidentHalfEdge();
+    do {
+        star.push_back(e->face());
+        link.push_back(e->next()->twin());
+        e = e->prev()->twin();
+    } while (e != v->incidentHalfEdge() && star.size() < convexHull.numberFaces());
+    if (star.size() + 1 >= convexHull.numberFaces())
+        return false;
+
+    //candidates: the link vertices, then the points owned by the star
+    std::vector<Pointd> local;
+    std::vector<unsigned int> candidates;
+    std::unordered_map<const Dcel::Vertex*, unsigned int> linkIndex;
+    for (Dcel::HalfEdge* h : link){
+        linkIndex[h->fromVertex()] = (unsigned int)local.size();
+        local.push_back(h->fromVertex()->coordinate());
+    }
+    const unsigned int nLink = (unsigned int)local.size();
+    for (Dcel::Face* f : star){
+        if (f->id() >= ownedPoints.size())
+            continue;
+        for (unsigned int q : ownedPoints[f->id()]){
+            candidates.push_back(q);
+            local.push_back(points[q]);
+        }
+    }
+
+    Dcel localHull;
+    std::vector<Pointd> localPoints(local);
+    internal::computeConvexHull(localHull, localPoints, ConvexHullOptions(QUICKHULL));
+    std::unordered_map<Pointd, unsigned int> localIndex;
+    for (unsigned int i = 0; i < local.size(); i++)
+        localIndex.insert(std::make_pair(local[i], i));
+
+    /**
+     * Le nuove facce sono le facce del local hull visibili dal punto cancellato, comprese
+     * quelle che lo contengono nel loro piano e non sono rivolte verso il centro (ad esempio
+     * le facce complanari alle facce del bordo del link, su input degeneri).
+     */
+    std::vector<unsigned int> triangles;
+    for (const Dcel::Face* f : localHull.faceIterator()){
+        if (!internal::isFaceVisible(f, p))
+            continue;
+        if (internal::isFaceVisible(f, center)){
+            if (internal::isFaceStrictlyVisible(f, p))
+                return false;
+            continue;
+        }
+        const Dcel::HalfEdge* he = f->outerHalfEdge();
+        for (unsigned int i = 0; i < 3; i++, he = he->next())
+            triangles.push_back(localIndex[he->fromVertex()->coordinate()]);
+    }
+
+    /**
+     * I vertici del link allineati con un lato del bordo non sono vertici del local hull:
+     * il triangolo del lato è diviso in un ventaglio dal vertice opposto, uno per ogni
+     * vertice della catena del link tra gli estremi del lato.
+     */
+    std::vector<unsigned int> nextLink(nLink);
+    for (Dcel::HalfEdge* h : link)
+        nextLink[linkIndex[h->fromVertex()]] = linkIndex[h->toVertex()];
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeTriangle; //position of the triangle of every side
+    for (unsigned int t = 0; t < triangles.size(); t += 3){
+        for (unsigned int i = 0; i < 3; i++){
+            if (!edgeTriangle.insert(std::make_pair(std::make_pair(triangles[t+i], triangles[t+(i+1)%3]), t)).second)
+                return false;
+        }
+    }
+    std::vector<std::pair<unsigned int, unsigned int> > splitEdges;
+    for (const std::pair<const std::pair<unsigned int, unsigned int>, unsigned int>& edge : edgeTriangle){
+        unsigned int a = edge.first.first, b = edge.first.second;
+        if (a < nLink && b < nLink && nextLink[b] != a && edgeTriangle.find(std::make_pair(b, a)) == edgeTriangle.end())
+            splitEdges.push_back(edge.first);
+    }
+    for (const std::pair<unsigned int, unsigned int>& edge : splitEdges){
+        unsigned int a = edge.first, b = edge.second;
+        unsigned int t = edgeTriangle[edge];
+        unsigned int i = 0;
+        while (triangles[t+i] != a)
+            i++;
+        unsigned int c = triangles[t+(i+2)%3];
+
+        //the chain b, x1, ..., xk, a of the link replaces the side a -> b
+        std::vector<unsigned int> chain;
+        for (unsigned int x = nextLink[b]; x != a; x = nextLink[x]){
+            if (chain.size() == nLink || !internal::areCollinear(local[a], local[b], local[x]))
+                return false;
+            chain.push_back(x);
+        }
+        chain.insert(chain.begin(), b);
+        chain.push_back(a);
+        for (unsigned int k = (unsigned int)chain.size() - 1; k > 0; k--){
+            unsigned int position = k + 1 == chain.size() ? t : (unsigned int)triangles.size();
+            if (position == triangles.size())
+                triangles.resize(triangles.size() + 3);
+            triangles[position] = chain[k];
+            triangles[position+1] = chain[k-1];
+            triangles[position+2] = c;
+            if (k == 1)
+                edgeTriangle[std::make_pair(b, c)] = position;
+        }
+    }
+
+    //the new faces must be a disk glued to the link
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> edges;
+    for (unsigned int t = 0; t < triangles.size(); t += 3){
+        for (unsigned int i = 0; i < 3; i++){
+            if (++edges[std::make_pair(triangles[t+i], triangles[t+(i+1)%3])] > 1)
+                return false;
+        }
+    }
+    unsigned int nBoundary = 0;
+    for (const std::pair<const std::pair<unsigned int, unsigned int>, unsigned int>& edge : edges){
+        if (edges.find(std::make_pair(edge.first.second, edge.first.first)) == edges.end())
+            nBoundary++;
+    }
+    if (nBoundary != link.size())
+        return false;
+    for (Dcel::HalfEdge* h : link){
+        std::pair<unsigned int, unsigned int> reverse(linkIndex[h->toVertex()], linkIndex[h->fromVertex()]);
+        if (edges.find(reverse) == edges.end() || edges.find(std::make_pair(reverse.second, reverse.first)) != edges.end())
+            return false;
+    }
+
+    //the replacement is valid: the star is deleted, and the new faces are glued to the link
+    orphans.clear();
+    deleteFaces(star);
+    convexHull.deleteVertex(v);
+    pointVertex[pid] = nullptr;
+
+    std::vector<Dcel::Vertex*> vertices(local.size(), nullptr);
+    for (Dcel::HalfEdge* h : link)
+        vertices[linkIndex[h->fromVertex()]] = h->fromVertex();
+    for (unsigned int t = 0; t < triangles.size(); t++){
+        unsigned int i = triangles[t];
+        if (vertices[i] == nullptr){
+            unsigned int q = candidates[i - nLink];
+            vertices[i] = convexHull.addVertex(local[i]);
+            pointVertex[q] = vertices[i];
+            if (vertices[i]->id() >= vertexPoint.size())
+                vertexPoint.resize(vertices[i]->id() + 1);
+            vertexPoint[vertices[i]->id()] = q;
+        }
+    }
+
+    std::map<std::pair<Dcel::Vertex*, Dcel::Vertex*>, Dcel::HalfEdge*> halfEdges;
+    for (Dcel::HalfEdge* h : link)
+        halfEdges[std::make_pair(h->fromVertex(), h->toVertex())] = h;
+    newFaces.clear();
+    for (unsigned int t = 0; t < triangles.size(); t += 3){
+        Dcel::Face* f = convexHull.addFace();
+        Dcel::HalfEdge* te[3];
+        for (unsigned int i = 0; i < 3; i++)
+            te[i] = convexHull.addHalfEdge();
+        for (unsigned int i = 0; i < 3; i++){
+            Dcel::Vertex* from = vertices[triangles[t+i]];
+            Dcel::Vertex* to = vertices[triangles[t+(i+1)%3]];
+            te[i]->setFromVertex(from);
+            te[i]->setToVertex(to);
+            te[i]->setNext(te[(i+1)%3]);
+            te[i]->setPrev(te[(i+2)%3]);
+            te[i]->setFace(f);
+            from->setIncidentHalfEdge(te[i]);
+            auto twin = halfEdges.find(std::make_pair(to, from));
+            if (twin != halfEdges.end()){
+                te[i]->setTwin(twin->second);
+                twin->second->setTwin(te[i]);
+            }
+            halfEdges[std::make_pair(from, to)] = te[i];
+        }
+        f->setOuterHalfEdge(te[0]);
+        newFaces.push_back(f);
+    }
+
+    for (unsigned int q : orphans){
+        if (pointVertex[q] == nullptr)
+            assign(q, newFaces);
+    }
+    lastFace = newFaces[0];
+    return true;
+}
+
+} //namespace cg3
@@ -0,0 +1,150 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Extreme points filter (Akl-Toussaint heuristic): removes from points all the
+ * points that are strictly inside the convex hull of the extreme points of points along
+ * 26 fixed directions (the directions of the faces, edges and vertices of a cube).
+ *
+ * The removed points cannot be vertices of the convex hull of points, hence the hull is
+ * not changed. The points are read in blocks: the coordinates of a block are copied in
+ * three separate arrays, so the projections on the directions and the distances from the
+ * planes of the filter polytope are computed by simple loops that the compiler vectorizes.
+ * The relative order of the remaining points is preserved.
+ *
+ * @param[in/out] points
+ * @param[in/out] indices: if not nullptr, an array parallel to points, from which the entries
+ * of the removed points are removed too
+ * @return the number of removed points
+ */
+inline unsigned int extremePointsFilter(std::vector<Pointd>& points, std::vector<unsigned int>* indices)
+{
+    const unsigned int nDirections = 13; //every direction gives two extreme points
+    const double directions[nDirections][3] = {
+        {1, 0, 0}, {0, 1, 0}, {0, 0, 1},
+        {1, 1, 0}, {1, -1, 0}, {1, 0, 1}, {1, 0, -1}, {0, 1, 1}, {0, 1, -1},
+        {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1}
+    };
+    const unsigned int blockSize = 256;
+    const unsigned int nPoints = (unsigned int)points.size();
+    if (nPoints <= 2*nDirections)
+        return 0;
+
+    double x[blockSize], y[blockSize], z[blockSize], v[blockSize];
+
+    //extreme points
+    double maxProjection[nDirections], minProjection[nDirections];
+    unsigned int maxPid[nDirections], minPid[nDirections];
+    for (unsigned int k = 0; k < nDirections; k++){
+        maxProjection[k] = minProjection[k] = points[0].x() * directions[k][0] + points[0].y() * directions[k][1] + points[0].z() * directions[k][2];
+        maxPid[k] = minPid[k] = 0;
+    }
+    for (unsigned int begin = 0; begin < nPoints; begin += blockSize){
+        unsigned int n = std::min(blockSize, nPoints - begin);
+        for (unsigned int j = 0; j < n; j++){
+            x[j] = points[begin+j].x();
+            y[j] = points[begin+j].y();
+            z[j] = points[begin+j].z();
+        }
+        for (unsigned int k = 0; k < nDirections; k++){
+            const double dx = directions[k][0], dy = directions[k][1], dz = directions[k][2];
+            for (unsigned int j = 0; j < n; j++)
+                v[j] = dx * x[j] + dy * y[j] + dz * z[j];
+            for (unsigned int j = 0; j < n; j++){
+                if (v[j] > maxProjection[k]){
+                    maxProjection[k] = v[j];
+                    maxPid[k] = begin + j;
+                }
+                else if (v[j] < minProjection[k]){
+                    minProjection[k] = v[j];
+                    minPid[k] = begin + j;
+                }
+            }
+        }
+    }
+
+    std::vector<unsigned int> extremePids(maxPid, maxPid + nDirections);
+    extremePids.insert(extremePids.end(), minPid, minPid + nDirections);
+    std::sort(extremePids.begin(), extremePids.end());
+    extremePids.erase(std::unique(extremePids.begin(), extremePids.end()), extremePids.end());
+    std::vector<Pointd> extremePoints;
+    for (unsigned int pid : extremePids)
+        extremePoints.push_back(points[pid]);
+    if (extremePoints.size() < 4 || areAllCoplanar(extremePoints))
+        return 0;
+
+    //planes of the faces of the hull of the extreme points, oriented outside
+    Pointd center, min = extremePoints[0], max = extremePoints[0];
+    for (const Pointd& p : extremePoints){
+        center += p;
+        min = min.min(p);
+        max = max.max(p);
+    }
+    center /= (double)extremePoints.size();
+    const double tolerance = 1e-10 * (max - min).length();
+
+    Dcel polytope;
+    randomizedIncrementalConvexHull(polytope, extremePoints);
+    std::vector<double> a, b, c, d;
+    for (const Dcel::Face* f : polytope.faceIterator()){
+        Dcel::Face::ConstIncidentVertexIterator vit = f->incidentVertexBegin();
+        const Pointd& p1 = (*vit)->coordinate();
+        vit++;
+        const Pointd& p2 = (*vit)->coordinate();
+        vit++;
+        const Pointd& p3 = (*vit)->coordinate();
+        Vec3 normal = (p2 - p1).cross(p3 - p1);
+        double length = normal.length();
+        if (length == 0)
+            return 0;
+        normal /= length;
+        if (normal.dot(center - p1) > 0)
+            normal = -normal;
+        a.push_back(normal.x());
+        b.push_back(normal.y());
+        c.push_back(normal.z());
+        d.push_back(-normal.dot(p1));
+    }
+
+    //removal of the points inside all the planes
+    unsigned int nKept = 0;
+    for (unsigned int begin = 0; begin < nPoints; begin += blockSize){
+        unsigned int n = std::min(blockSize, nPoints - begin);
+        for (unsigned int j = 0; j < n; j++){
+            x[j] = points[begin+j].x();
+            y[j] = points[begin+j].y();
+            z[j] = points[begin+j].z();
+            v[j] = -std::numeric_limits<double>::max();
+        }
+        for (unsigned int k = 0; k < a.size(); k++){
+            const double pa = a[k], pb = b[k], pc = c[k], pd = d[k];
+            for (unsigned int j = 0; j < n; j++){
+                double distance = pa * x[j] + pb * y[j] + pc * z[j] + pd;
+                v[j] = distance > v[j] ? distance : v[j];
+            }
+        }
+        for (unsigned int j = 0; j < n; j++){
+            if (v[j] >= -tolerance){
+                if (indices != nullptr)
+                    (*indices)[nKept] = (*indices)[begin+j];
+                points[nKept++] = points[begin+j];
+            }
+        }
+    }
+    points.erase(points.begin() + nKept, points.end());
+    if (indices != nullptr)
+        indices->resize(nKept);
+    return nPoints - nKept;
+}
+
+} //namespace cg3::internal
+} //namespace cg3
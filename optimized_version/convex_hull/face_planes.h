@@ -0,0 +1,81 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_FACE_PLANES_H
+#define CG3_CONVEXHULL_FACE_PLANES_H
+
+#include <vector>
+#include <geometry/point.h>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief The PointCoordinates class stores the coordinates of an array of points in three
+ * separate arrays (structure of arrays), so that loops over the points can be vectorized.
+ */
+class PointCoordinates
+{
+public:
+    PointCoordinates();
+    PointCoordinates(const std::vector<Pointd>& points);
+
+    void assign(const std::vector<Pointd>& points);
+
+    unsigned int size() const;
+    const double* x() const;
+    const double* y() const;
+    const double* z() const;
+
+protected:
+    std::vector<double> xs, ys, zs;
+};
+
+/**
+ * @brief The FacePlanes class caches the plane of every face of the incremental convex hull,
+ * indexed by the id of the face in the Dcel.
+ *
+ * A plane is stored as its first vertex a and the normal n = (b-a)x(c-a), together with the
+ * absolute values of the products that compose n: for a point p, n.(p-a) is exactly the
+ * floating point expression evaluated by orient3d, hence its sign can be certified with the
+ * same static error bound. The classification of a list of points is a single branch-free
+ * loop over the PointCoordinates; only the points that the bound cannot certify must be
+ * tested again with the exact predicate.
+ */
+class FacePlanes
+{
+public:
+    FacePlanes();
+
+    void setFace(unsigned int fid, const Pointd& a, const Pointd& b, const Pointd& c);
+
+    void classify(
+            unsigned int fid,
+            const PointCoordinates& coords,
+            const std::vector<unsigned int>& pids,
+            std::vector<signed char>& sides) const;
+    void classify(
+            unsigned int fid,
+            const PointCoordinates& coords,
+            unsigned int begin,
+            unsigned int end,
+            std::vector<signed char>& sides) const;
+    signed char side(unsigned int fid, const Pointd& p) const;
+    double distance(unsigned int fid, const Pointd& p) const;
+
+protected:
+    std::vector<double> ax, ay, az; //first vertex
+    std::vector<double> nx, ny, nz; //normal
+    std::vector<double> mx, my, mz; //magnitude of the products of the normal
+};
+
+} //namespace cg3::internal
+} //namespace cg3
+
+#include "face_planes.tpp"
+
+#endif // CG3_CONVEXHULL_FACE_PLANES_H
@@ -0,0 +1,213 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "face_planes.h"
+#include <geometry/predicates.h>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief PointCoordinates::PointCoordinates
+ * Default constructor. It creates an empty array of points.
+ */
+inline PointCoordinates::PointCoordinates()
+{
+}
+
+/**
+ * @brief PointCoordinates::PointCoordinates
+ * Copies the coordinates of points.
+ * @param[in] points
+ */
+inline PointCoordinates::PointCoordinates(const std::vector<Pointd>& points)
+{
+    assign(points);
+}
+
+/**
+ * @brief PointCoordinates::assign
+ * Replaces the stored coordinates with the coordinates of points.
+ * @param[in] points
+ */
+inline void PointCoordinates::assign(const std::vector<Pointd>& points)
+{
+    xs.resize(points.size());
+    ys.resize(points.size());
+    zs.resize(points.size());
+    for (unsigned int i = 0; i < points.size(); i++){
+        xs[i] = points[i].x();
+        ys[i] = points[i].y();
+        zs[i] = points[i].z();
+    }
+}
+
+/**
+ * @brief PointCoordinates::size
+ * @return the number of points
+ */
+inline unsigned int PointCoordinates::size() const
+{
+    return (unsigned int)xs.size();
+}
+
+inline const double* PointCoordinates::x() const
+{
+    return xs.data();
+}
+
+inline const double* PointCoordinates::y() const
+{
+    return ys.data();
+}
+
+inline const double* PointCoordinates::z() const
+{
+    return zs.data();
+}
+
+/**
+ * @brief FacePlanes::FacePlanes
+ * Default constructor. It creates an empty set of planes.
+ */
+inline FacePlanes::FacePlanes()
+{
+}
+
+/**
+ * @brief FacePlanes::setFace
+ * Computes and stores the plane of the face fid, whose vertices are a, b and c in
+ * counterclockwise order (seen from outside the hull). The slot of a deleted face is
+ * reused when the Dcel reuses its id.
+ * @param[in] fid: the id of the face in the Dcel
+ * @param[in] a
+ * @param[in] b
+ * @param[in] c
+ */
+inline void FacePlanes::setFace(unsigned int fid, const Pointd& a, const Pointd& b, const Pointd& c)
+{
+    if (fid >= ax.size()){
+        unsigned int size = fid + 1;
+        ax.resize(size); ay.resize(size); az.resize(size);
+        nx.resize(size); ny.resize(size); nz.resize(size);
+        mx.resize(size); my.resize(size); mz.resize(size);
+    }
+    double ux = b.x() - a.x(), uy = b.y() - a.y(), uz = b.z() - a.z();
+    double vx = c.x() - a.x(), vy = c.y() - a.y(), vz = c.z() - a.z();
+
+    double uyvz = uy * vz, uzvy = uz * vy;
+    double uzvx = uz * vx, uxvz = ux * vz;
+    double uxvy = ux * vy, uyvx = uy * vx;
+
+    ax[fid] = a.x(); ay[fid] = a.y(); az[fid] = a.z();
+    nx[fid] = uyvz - uzvy;
+    ny[fid] = uzvx - uxvz;
+    nz[fid] = uxvy - uyvx;
+    mx[fid] = std::fabs(uyvz) + std::fabs(uzvy);
+    my[fid] = std::fabs(uzvx) + std::fabs(uxvz);
+    mz[fid] = std::fabs(uxvy) + std::fabs(uyvx);
+}
+
+/**
+ * @brief FacePlanes::classify
+ * Classifies the points pids with respect to the plane of the face fid. For every k,
+ * sides[k] is set to:
+ * - 1 if pids[k] is certainly outside the face (the face is visible);
+ * - -1 if pids[k] is certainly inside the face (the face is not visible);
+ * - 0 if the floating point evaluation is not reliable: the point is on the plane or very
+ *   close to it, and must be tested with the exact predicate.
+ * @param[in] fid
+ * @param[in] coords: the coordinates of all the points
+ * @param[in] pids: the indices in coords of the points to classify
+ * @param[out] sides
+ */
+inline void FacePlanes::classify(
+        unsigned int fid,
+        const PointCoordinates& coords,
+        const std::vector<unsigned int>& pids,
+        std::vector<signed char>& sides) const
+{
+    const double fax = ax[fid], fay = ay[fid], faz = az[fid];
+    const double fnx = nx[fid], fny = ny[fid], fnz = nz[fid];
+    const double fmx = mx[fid], fmy = my[fid], fmz = mz[fid];
+    const double* x = coords.x();
+    const double* y = coords.y();
+    const double* z = coords.z();
+    const unsigned int n = (unsigned int)pids.size();
+    sides.resize(n);
+    for (unsigned int k = 0; k < n; k++){
+        const unsigned int pid = pids[k];
+        double wx = x[pid] - fax, wy = y[pid] - fay, wz = z[pid] - faz;
+        double det = wx * fnx + wy * fny + wz * fnz;
+        double errorBound = orient3dErrorBound * (std::fabs(wx) * fmx + std::fabs(wy) * fmy + std::fabs(wz) * fmz);
+        sides[k] = (signed char)((det > errorBound) - (-det > errorBound));
+    }
+}
+
+/**
+ * @brief FacePlanes::classify
+ * Classifies the points of coords in the range [begin, end) with respect to the plane of
+ * the face fid: sides[k] refers to the point begin+k (see the other overload).
+ * @param[in] fid
+ * @param[in] coords: the coordinates of all the points
+ * @param[in] begin
+ * @param[in] end
+ * @param[out] sides
+ */
+inline void FacePlanes::classify(
+        unsigned int fid,
+        const PointCoordinates& coords,
+        unsigned int begin,
+        unsigned int end,
+        std::vector<signed char>& sides) const
+{
+    const double fax = ax[fid], fay = ay[fid], faz = az[fid];
+    const double fnx = nx[fid], fny = ny[fid], fnz = nz[fid];
+    const double fmx = mx[fid], fmy = my[fid], fmz = mz[fid];
+    const double* x = coords.x() + begin;
+    const double* y = coords.y() + begin;
+    const double* z = coords.z() + begin;
+    const unsigned int n = end - begin;
+    sides.resize(n);
+    for (unsigned int k = 0; k < n; k++){
+        double wx = x[k] - fax, wy = y[k] - fay, wz = z[k] - faz;
+        double det = wx * fnx + wy * fny + wz * fnz;
+        double errorBound = orient3dErrorBound * (std::fabs(wx) * fmx + std::fabs(wy) * fmy + std::fabs(wz) * fmz);
+        sides[k] = (signed char)((det > errorBound) - (-det > errorBound));
+    }
+}
+
+/**
+ * @brief FacePlanes::side
+ * Classifies a single point with respect to the plane of the face fid (see classify).
+ * @param[in] fid
+ * @param[in] p
+ * @return 1 if p is certainly outside the face, -1 if it is certainly inside, 0 if the
+ * exact predicate is needed
+ */
+inline signed char FacePlanes::side(unsigned int fid, const Pointd& p) const
+{
+    double wx = p.x() - ax[fid], wy = p.y() - ay[fid], wz = p.z() - az[fid];
+    double det = wx * nx[fid] + wy * ny[fid] + wz * nz[fid];
+    double errorBound = orient3dErrorBound * (std::fabs(wx) * mx[fid] + std::fabs(wy) * my[fid] + std::fabs(wz) * mz[fid]);
+    return (signed char)((det > errorBound) - (-det > errorBound));
+}
+
+/**
+ * @brief FacePlanes::distance
+ * @param[in] fid
+ * @param[in] p
+ * @return the floating point evaluation of n.(p-a): the distance of p from the plane of the
+ * face fid (positive outside), scaled by the length of the normal
+ */
+inline double FacePlanes::distance(unsigned int fid, const Pointd& p) const
+{
+    return (p.x() - ax[fid]) * nx[fid] + (p.y() - ay[fid]) * ny[fid] + (p.z() - az[fid]) * nz[fid];
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,60 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_INSTRUMENTATION_H
+#define CG3_CONVEXHULL_INSTRUMENTATION_H
+
+#include <string>
+
+/**
+ * The counters of the hull engines are collected only if CG3_CONVEXHULL_INSTRUMENTATION is
+ * defined: otherwise, the statements passed to CG3_CONVEXHULL_COUNT are removed, and the
+ * counters are always zero.
+ */
+#ifdef CG3_CONVEXHULL_INSTRUMENTATION
+#define CG3_CONVEXHULL_COUNT(...) __VA_ARGS__
+#else
+#define CG3_CONVEXHULL_COUNT(...)
+#endif
+
+namespace cg3 {
+
+/**
+ * @brief The counters and the phase timings of a run of the randomized incremental algorithm.
+ */
+struct ConvexHullCounters {
+    ConvexHullCounters();
+
+    static bool isEnabled();
+
+    std::string toJson() const;
+
+    unsigned long long orientationTests; //orientation tests evaluated with the (filtered) exact predicate
+    unsigned long long planeTests; //orientation tests classified with the cached face planes
+    unsigned long long conflictArcsCreated;
+    unsigned long long conflictArcsDeleted;
+    unsigned long long peakConflictArcs; //maximum number of arcs in the conflict graph
+    unsigned long long insertedPoints; //points that became vertices of the hull
+    unsigned long long discardedPoints; //points found inside the hull
+    unsigned long long visibleFaces; //sum over the insertions
+    unsigned long long maxVisibleFaces;
+    unsigned long long horizonEdges; //sum over the insertions
+    unsigned long long maxHorizonEdges;
+    unsigned long long facesCreated;
+    unsigned long long facesDeleted;
+
+    double initializationTime; //seconds: shuffle, insertion order and initial tetrahedron
+    double conflictSetupTime; //seconds: initial conflict graph
+    double insertionTime; //seconds: insertion loop
+    double postProcessingTime; //seconds: normals and bounding box of the output
+};
+
+} //namespace cg3
+
+#include "instrumentation.tpp"
+
+#endif // CG3_CONVEXHULL_INSTRUMENTATION_H
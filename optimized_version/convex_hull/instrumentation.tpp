@@ -0,0 +1,80 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "instrumentation.h"
+#include <sstream>
+
+namespace cg3 {
+
+inline ConvexHullCounters::ConvexHullCounters() :
+    orientationTests(0),
+    planeTests(0),
+    conflictArcsCreated(0),
+    conflictArcsDeleted(0),
+    peakConflictArcs(0),
+    insertedPoints(0),
+    discardedPoints(0),
+    visibleFaces(0),
+    maxVisibleFaces(0),
+    horizonEdges(0),
+    maxHorizonEdges(0),
+    facesCreated(0),
+    facesDeleted(0),
+    initializationTime(0),
+    conflictSetupTime(0),
+    insertionTime(0),
+    postProcessingTime(0)
+{
+}
+
+/**
+ * @brief ConvexHullCounters::isEnabled
+ * @return true if the library has been compiled with CG3_CONVEXHULL_INSTRUMENTATION
+ */
+inline bool ConvexHullCounters::isEnabled()
+{
+    #ifdef CG3_CONVEXHULL_INSTRUMENTATION
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+/**
+ * @brief ConvexHullCounters::toJson
+ * @return the counters as a JSON object, with the averages per insertion of the visible faces
+ * and of the horizon edges, and the phase timings in seconds
+ */
+inline std::string ConvexHullCounters::toJson() const
+{
+    double nInsertions = insertedPoints > 0 ? (double)insertedPoints : 1;
+    std::ostringstream json;
+    json << "{"
+         << "\"enabled\": " << (isEnabled() ? "true" : "false") << ", "
+         << "\"orientationTests\": " << orientationTests << ", "
+         << "\"planeTests\": " << planeTests << ", "
+         << "\"conflictArcsCreated\": " << conflictArcsCreated << ", "
+         << "\"conflictArcsDeleted\": " << conflictArcsDeleted << ", "
+         << "\"peakConflictArcs\": " << peakConflictArcs << ", "
+         << "\"insertedPoints\": " << insertedPoints << ", "
+         << "\"discardedPoints\": " << discardedPoints << ", "
+         << "\"visibleFaces\": {\"total\": " << visibleFaces << ", \"max\": " << maxVisibleFaces
+         << ", \"mean\": " << visibleFaces / nInsertions << "}, "
+         << "\"horizonEdges\": {\"total\": " << horizonEdges << ", \"max\": " << maxHorizonEdges
+         << ", \"mean\": " << horizonEdges / nInsertions << "}, "
+         << "\"facesCreated\": " << facesCreated << ", "
+         << "\"facesDeleted\": " << facesDeleted << ", "
+         << "\"phases\": {"
+         << "\"initialization\": " << initializationTime << ", "
+         << "\"conflictSetup\": " << conflictSetupTime << ", "
+         << "\"insertion\": " << insertionTime << ", "
+         << "\"postProcessing\": " << postProcessingTime << "}"
+         << "}";
+    return json.str();
+}
+
+} //namespace cg3
@@ -0,0 +1,312 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Exact orientation of four integer points, with the sign of orient3d(a, b, c, d)
+ * (negative if d is outside the face (a, b, c), counterclockwise seen from outside).
+ *
+ * The differences of two int coordinates are smaller than 2^32 and fit in 64 bits; the 2x2
+ * minors are smaller than 2^65 and the determinant is smaller than 2^99, hence they are
+ * computed exactly in 128 bits for all the int coordinates, without any filter.
+ */
+inline __int128 integerOrientation(const Pointi& a, const Pointi& b, const Pointi& c, const Pointi& d)
+{
+    long long adx = (long long)a.x() - d.x(), bdx = (long long)b.x() - d.x(), cdx = (long long)c.x() - d.x();
+    long long ady = (long long)a.y() - d.y(), bdy = (long long)b.y() - d.y(), cdy = (long long)c.y() - d.y();
+    long long adz = (long long)a.z() - d.z(), bdz = (long long)b.z() - d.z(), cdz = (long long)c.z() - d.z();
+
+    __int128 bc = (__int128)bdx * cdy - (__int128)cdx * bdy;
+    __int128 ca = (__int128)cdx * ady - (__int128)adx * cdy;
+    __int128 ab = (__int128)adx * bdy - (__int128)bdx * ady;
+    return adz * bc + bdz * ca + cdz * ab;
+}
+
+/**
+ * @brief Returns the integer coordinates of a vertex of a hull of integer points (they are
+ * stored exactly in the doubles of the Dcel).
+ */
+inline Pointi integerCoordinate(const Dcel::Vertex* v)
+{
+    const Pointd& p = v->coordinate();
+    return Pointi((int)p.x(), (int)p.y(), (int)p.z());
+}
+
+/**
+ * @brief The plane of a face of a hull of integer points: the outward normal (b - a) x (c - a)
+ * of its triangle abc, whose components are smaller than 2^65, and the vertex a.
+ */
+struct IntegerPlane {
+    __int128 normal[3];
+    Pointi a;
+};
+
+inline IntegerPlane integerFacePlane(const Dcel::Face* f)
+{
+    const Dcel::HalfEdge* e = f->outerHalfEdge();
+    IntegerPlane plane;
+    plane.a = integerCoordinate(e->fromVertex());
+    Pointi b = integerCoordinate(e->toVertex());
+    Pointi c = integerCoordinate(e->next()->toVertex());
+    long long ux = (long long)b.x() - plane.a.x(), uy = (long long)b.y() - plane.a.y(), uz = (long long)b.z() - plane.a.z();
+    long long vx = (long long)c.x() - plane.a.x(), vy = (long long)c.y() - plane.a.y(), vz = (long long)c.z() - plane.a.z();
+    plane.normal[0] = (__int128)uy * vz - (__int128)uz * vy;
+    plane.normal[1] = (__int128)uz * vx - (__int128)ux * vz;
+    plane.normal[2] = (__int128)ux * vy - (__int128)uy * vx;
+    return plane;
+}
+
+/**
+ * @brief Returns the exact signed distance of p from the plane, scaled by the length of the
+ * normal (smaller than 2^99): positive if p is strictly outside the face, 0 if it is on its
+ * plane. It has the opposite sign of integerOrientation.
+ */
+inline __int128 integerPlaneDistance(const IntegerPlane& plane, const Pointi& p)
+{
+    return plane.normal[0] * ((long long)p.x() - plane.a.x()) +
+           plane.normal[1] * ((long long)p.y() - plane.a.y()) +
+           plane.normal[2] * ((long long)p.z() - plane.a.z());
+}
+
+/**
+ * @brief Searches four non coplanar points, as findInitialSimplex: the candidates are the
+ * extreme points along the three axes, and all the points if they are degenerate. Distances
+ * are compared in floating point (they only choose among valid candidates), while the tests of
+ * collinearity and coplanarity are exact.
+ * @return the number of affinely independent points found
+ */
+inline unsigned int integerSimplexSearch(const std::vector<Pointi>& points, const unsigned int* ids, unsigned int n, unsigned int simplex[4])
+{
+    if (n == 0)
+        return 0;
+    auto id = [ids](unsigned int i) {return ids == nullptr ? i : ids[i];};
+    auto distance = [&](unsigned int i, unsigned int j){
+        double dx = (double)points[i].x() - points[j].x();
+        double dy = (double)points[i].y() - points[j].y();
+        double dz = (double)points[i].z() - points[j].z();
+        return dx * dx + dy * dy + dz * dz;
+    };
+
+    //the farthest point from the first candidate, and the farthest point from it
+    unsigned int s0 = id(0), s1 = id(0);
+    double maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        double d = distance(id(i), s0);
+        if (d > maxDist){
+            maxDist = d;
+            s1 = id(i);
+        }
+    }
+    simplex[0] = s1;
+    if (maxDist == 0)
+        return 1;
+    maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        double d = distance(id(i), s1);
+        if (d > maxDist){
+            maxDist = d;
+            s0 = id(i);
+        }
+    }
+    simplex[0] = s0;
+    simplex[1] = s1;
+
+    //the farthest point from the line s0 s1: the components of the cross product are exact
+    const Pointi& p0 = points[s0];
+    long long ux = (long long)points[s1].x() - p0.x(), uy = (long long)points[s1].y() - p0.y(), uz = (long long)points[s1].z() - p0.z();
+    maxDist = 0;
+    for (unsigned int i = 0; i < n; i++){
+        const Pointi& p = points[id(i)];
+        long long vx = (long long)p.x() - p0.x(), vy = (long long)p.y() - p0.y(), vz = (long long)p.z() - p0.z();
+        double cx = (double)((__int128)uy * vz - (__int128)uz * vy);
+        double cy = (double)((__int128)uz * vx - (__int128)ux * vz);
+        double cz = (double)((__int128)ux * vy - (__int128)uy * vx);
+        double d = cx * cx + cy * cy + cz * cz;
+        if (d > maxDist){
+            maxDist = d;
+            simplex[2] = id(i);
+        }
+    }
+    if (maxDist == 0)
+        return 2;
+
+    //the farthest point from the plane s0 s1 s2
+    __int128 maxVolume = 0;
+    for (unsigned int i = 0; i < n; i++){
+        __int128 v = integerOrientation(points[s0], points[s1], points[simplex[2]], points[id(i)]);
+        if (v < 0)
+            v = -v;
+        if (v > maxVolume){
+            maxVolume = v;
+            simplex[3] = id(i);
+        }
+    }
+    return maxVolume == 0 ? 3 : 4;
+}
+
+/**
+ * @brief Moves in the first four positions of points four non coplanar points, and inserts in
+ * dcel their tetrahedron, as insertInitialTet.
+ * @return false if the points are coplanar: in this case nothing is inserted in dcel
+ */
+inline bool insertIntegerInitialTet(Dcel& dcel, std::vector<Pointi>& points)
+{
+    const unsigned int nPoints = (unsigned int)points.size();
+    if (nPoints < 4)
+        return false;
+    unsigned int extremes[6] = {0, 0, 0, 0, 0, 0}; //min x, max x, min y, max y, min z, max z
+    for (unsigned int i = 1; i < nPoints; i++){
+        for (unsigned int a = 0; a < 3; a++){
+            if (points[i][a] < points[extremes[2*a]][a])
+                extremes[2*a] = i;
+            else if (points[i][a] > points[extremes[2*a+1]][a])
+                extremes[2*a+1] = i;
+        }
+    }
+    unsigned int simplex[4];
+    if (integerSimplexSearch(points, extremes, 6, simplex) < 4 &&
+            integerSimplexSearch(points, nullptr, nPoints, simplex) < 4)
+        return false;
+
+    unsigned int indices[4] = {simplex[0], simplex[1], simplex[2], simplex[3]};
+    for (unsigned int i = 0; i < 4; i++){
+        std::swap(points[i], points[indices[i]]);
+        for (unsigned int j = i+1; j < 4; j++){
+            if (indices[j] == i)
+                indices[j] = indices[i];
+        }
+    }
+
+    Pointd p[4];
+    for (unsigned int i = 0; i < 4; i++)
+        p[i] = Pointd(points[i].x(), points[i].y(), points[i].z());
+    if (integerOrientation(points[0], points[1], points[2], points[3]) > 0)
+        insertTet(dcel, p[0], p[1], p[2], p[3]);
+    else
+        insertTet(dcel, p[1], p[0], p[2], p[3]);
+    return true;
+}
+
+/**
+ * @brief The policy of quickHullLoop for integer points: the plane of every face is computed
+ * once, exactly, and the points are tested against it with integerPlaneDistance. As in
+ * QuickHullPolicy, a point is assigned to the first new face that it sees, and the faces are
+ * processed in LIFO order, inserting the point farthest from the plane of the face. The
+ * predicates in double of addCoplanarFaces are exact on the integer coordinates.
+ */
+struct IntegerQuickHullPolicy {
+    IntegerQuickHullPolicy(Dcel& convexHull, const ConflictGraph& cg, const std::vector<Pointi>& points) :
+        convexHull(convexHull),
+        cg(cg),
+        points(points)
+    {
+    }
+
+    Pointd point(unsigned int pid) const
+    {
+        return Pointd(points[pid].x(), points[pid].y(), points[pid].z());
+    }
+
+    bool isOutside(const Dcel::Face* f, unsigned int pid) const
+    {
+        return integerPlaneDistance(planes[f->id()], points[pid]) > 0;
+    }
+
+    //the planes are indexed by the ids of the faces (a reused id gets the plane of its new face)
+    void addFaces(const std::vector<Dcel::Face*>& faces)
+    {
+        for (const Dcel::Face* f : faces){
+            if (f->id() >= planes.size())
+                planes.resize(f->id() + 1);
+            planes[f->id()] = integerFacePlane(f);
+        }
+    }
+
+    int outsideFace(const std::vector<Dcel::Face*>& faces, unsigned int pid) const
+    {
+        for (unsigned int i = 0; i < faces.size(); i++){
+            if (isOutside(faces[i], pid))
+                return (int)i;
+        }
+        return -1;
+    }
+
+    void pushFace(const Dcel::Face* f)
+    {
+        if (cg.sizeConflictsFace(f->id()) > 0)
+            pendingFaces.push_back(f->id());
+    }
+
+    bool nextPoint(Dcel::Face*& f, unsigned int& pid)
+    {
+        return nextFarthestPoint(convexHull, cg, pendingFaces, [this](unsigned int fid, unsigned int q){
+            return integerPlaneDistance(planes[fid], points[q]);
+        }, f, pid);
+    }
+
+    Dcel& convexHull;
+    const ConflictGraph& cg;
+    const std::vector<Pointi>& points;
+    std::vector<IntegerPlane> planes;
+    std::vector<unsigned int> pendingFaces;
+};
+
+/**
+ * @brief Exact Quickhull for integer points: inserts in convexHull the hull of points (whose
+ * order is changed), with quickHullLoop and an IntegerQuickHullPolicy. If the points are
+ * coplanar, convexHull is left empty.
+ */
+inline void integerQuickHull(Dcel& convexHull, std::vector<Pointi>& points, ConvexHullControl* control)
+{
+    if (!insertIntegerInitialTet(convexHull, points))
+        return;
+    ConvexHullWorkspace workspace;
+    IntegerQuickHullPolicy policy(convexHull, workspace.cg, points);
+    const unsigned int simplex[4] = {0, 1, 2, 3};
+    quickHullLoop(convexHull, workspace, policy, (unsigned int)points.size(), simplex, control);
+}
+
+/**
+ * @brief Computes the hull of integer points with integerQuickHull (or, if they are coplanar,
+ * with insertFlatHull, whose predicates are exact on their double coordinates), and fills
+ * statistics (if not nullptr).
+ * @return false if the computation has been cancelled (convexHull is then empty)
+ */
+inline bool computeIntegerConvexHull(Dcel& convexHull, std::vector<Pointi>& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    ConvexHullControl control(options.progress, options.deadline, options.cancel, (unsigned int)points.size());
+    if (statistics != nullptr){
+        *statistics = ConvexHullStatistics();
+        statistics->nInputPoints = points.size();
+    }
+    bool completed = !control.mustStop();
+    if (completed)
+        integerQuickHull(convexHull, points, &control);
+    if (control.isStopped()){
+        convexHull.clear();
+        completed = false;
+    }
+    else if (convexHull.numberVertices() == 0){
+        std::vector<Pointd> flatPoints;
+        flatPoints.reserve(points.size());
+        for (const Pointi& p : points)
+            flatPoints.push_back(Pointd(p.x(), p.y(), p.z()));
+        insertFlatHull(convexHull, flatPoints);
+    }
+    if (completed)
+        control.finish();
+    if (statistics != nullptr)
+        statistics->cancelled = !completed;
+    return completed;
+}
+
+} //namespace cg3::internal
+} //namespace cg3
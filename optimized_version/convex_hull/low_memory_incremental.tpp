@@ -0,0 +1,209 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <random>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Returns true if p is inside the cone from center (strictly inside the hull) through
+ * the triangle f, boundary included.
+ */
+inline bool isInFaceCone(const Dcel::Face* f, const Pointd& center, const Pointd& p)
+{
+    const Dcel::HalfEdge* e = f->outerHalfEdge();
+    for (unsigned int i = 0; i < 3; i++, e = e->next()){
+        if (areCoplanar(center, e->fromVertex()->coordinate(), e->toVertex()->coordinate(), p) > 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Visibility walk from the face start to the face crossed by the ray from center
+ * (strictly inside the hull) through p: at every step the walk crosses an edge whose plane
+ * (with the center) separates the face from p. The first edge tested rotates at every step,
+ * so that the walk cannot cycle.
+ * @param[in] maxSteps: the walk is interrupted after this number of steps
+ * @return the face crossed by the ray, or nullptr if the walk has been interrupted
+ */
+inline Dcel::Face* walkToFace(Dcel::Face* start, const Pointd& center, const Pointd& p, unsigned int maxSteps)
+{
+    Dcel::Face* f = start;
+    for (unsigned int step = 0; step < maxSteps; step++){
+        Dcel::HalfEdge* e = f->outerHalfEdge();
+        for (unsigned int i = 0; i < step % 3; i++)
+            e = e->next();
+        Dcel::Face* next = nullptr;
+        for (unsigned int i = 0; i < 3 && next == nullptr; i++, e = e->next()){
+            if (areCoplanar(center, e->fromVertex()->coordinate(), e->toVertex()->coordinate(), p) > 0)
+                next = e->twin()->face();
+        }
+        if (next == nullptr)
+            return f;
+        f = next;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Returns the face of convexHull crossed by the ray from center (strictly inside the
+ * hull) through p, with a walk from the face start. If the walk does not end in a number of
+ * steps equal to the number of faces, all the faces are tested.
+ */
+inline Dcel::Face* locateFace(Dcel& convexHull, Dcel::Face* start, const Pointd& center, const Pointd& p)
+{
+    Dcel::Face* f = walkToFace(start, center, p, convexHull.numberFaces());
+    if (f != nullptr)
+        return f;
+    for (Dcel::Face* g : convexHull.faceIterator()){
+        if (isInFaceCone(g, center, p))
+            return g;
+    }
+    return start;
+}
+
+/**
+ * @brief Deletes from ch the visible faces, their half edges and their vertices which are not
+ * on the horizon, without a conflict graph.
+ */
+inline void deleteVisibleFaces(Dcel& ch, const std::set<Dcel::Vertex*>& horizonVertices, const std::set<Dcel::Face*>& visibleFaces)
+{
+    std::set<Dcel::Vertex*> innerVertices;
+    for (Dcel::Face* f : visibleFaces){
+        Dcel::HalfEdge* e1 = f->outerHalfEdge();
+        Dcel::HalfEdge* e2 = e1->next();
+        Dcel::HalfEdge* e3 = e2->next();
+        Dcel::Vertex* vertices[3] = {e1->fromVertex(), e2->fromVertex(), e3->fromVertex()};
+        ch.deleteHalfEdge(e1);
+        ch.deleteHalfEdge(e2);
+        ch.deleteHalfEdge(e3);
+        ch.deleteFace(f);
+        for (Dcel::Vertex* v : vertices){
+            if (horizonVertices.find(v) == horizonVertices.end())
+                innerVertices.insert(v);
+        }
+    }
+    for (Dcel::Vertex* v : innerVertices)
+        ch.deleteVertex(v);
+}
+
+/**
+ * @brief A coarse grid on the bounding box of the points, whose cells store the id of a face
+ * of the hull located near them (-1: none). The faces of the hull reuse the ids of the deleted
+ * ones, but a reused id is still a valid start for a walk.
+ */
+struct LocationGrid {
+    static const unsigned int resolution = 16; //cells along every axis
+
+    Pointd min;
+    double scale[3];
+    std::vector<int> faces;
+};
+
+inline void initLocationGrid(LocationGrid& grid, const std::vector<Pointd>& points)
+{
+    Pointd max = points[0];
+    grid.min = points[0];
+    for (const Pointd& p : points){
+        grid.min = grid.min.min(p);
+        max = max.max(p);
+    }
+    for (unsigned int i = 0; i < 3; i++)
+        grid.scale[i] = max[i] > grid.min[i] ? LocationGrid::resolution / (max[i] - grid.min[i]) : 0;
+    grid.faces.assign(LocationGrid::resolution * LocationGrid::resolution * LocationGrid::resolution, -1);
+}
+
+inline int& locationCell(LocationGrid& grid, const Pointd& p)
+{
+    const unsigned int r = LocationGrid::resolution;
+    unsigned int c[3];
+    for (unsigned int i = 0; i < 3; i++)
+        c[i] = std::min((unsigned int)((p[i] - grid.min[i]) * grid.scale[i]), r - 1);
+    return grid.faces[(c[0] * r + c[1]) * r + c[2]];
+}
+
+/**
+ * @brief Randomized incremental algorithm without conflict graph: inserts in convexHull the
+ * hull of points, whose order is changed.
+ *
+ * The points are inserted in random (or BRIO) order. A point is located by walking on the hull
+ * towards the face crossed by the ray from a fixed center, strictly inside the initial
+ * tetrahedron, through the point: the point is outside the hull if and only if it sees that
+ * face, and in this case its visible faces are found by flooding from it. The walk starts
+ * from the last face created or located; if it takes more than a few steps, it restarts from
+ * the face stored in the cell of the point of a coarse grid. Besides the input, the memory
+ * used is proportional to the size of the hull.
+ */
+inline void lowMemoryIncrementalConvexHull(Dcel& convexHull, std::vector<Pointd>& points, ConvexHullInsertionOrder order, unsigned int nThreads, ConvexHullControl* control)
+{
+    const unsigned int maxSteps = 16; //steps of the walk from the last face
+
+    std::mt19937 rng(std::mt19937::default_seed);
+    std::shuffle(points.begin(), points.end(), rng);
+    if (order == BRIO_ORDER)
+        brioOrder(points, nThreads);
+
+    unsigned int nPoints = (unsigned int)points.size();
+    if (!insertInitialTet(convexHull, points))
+        return;
+
+    /**
+     * Il baricentro del tetraedro iniziale deve essere strettamente interno a tutte le sue
+     * facce (e quindi a tutti gli hull successivi): se l'arrotondamento lo porta sul bordo
+     * di un tetraedro molto sottile, si usa l'algoritmo Quickhull.
+     */
+    Pointd center = (points[0] + points[1] + points[2] + points[3]) / 4;
+    for (const Dcel::Face* f : convexHull.faceIterator()){
+        if (isFaceVisible(f, center)){
+            convexHull.clear();
+            quickHull(convexHull, points, control);
+            return;
+        }
+    }
+
+    LocationGrid grid;
+    initLocationGrid(grid, points);
+    std::set<Dcel::Face*> visibleFaces;
+    std::set<Dcel::Vertex*> horizonVertex;
+    std::vector<Dcel::HalfEdge*> horizonEdges;
+    std::vector<Dcel::Face*> stack;
+    std::vector<Dcel::Face*> newFaces;
+    Dcel::Face* lastFace = *convexHull.faceBegin();
+
+    for (unsigned int i = 4; i < nPoints && (control == nullptr || !control->poll(i)); i++){
+        const Pointd& p = points[i];
+        Dcel::Face* f = walkToFace(lastFace, center, p, maxSteps);
+        if (f == nullptr){
+            int fid = locationCell(grid, p);
+            Dcel::Face* start = fid >= 0 ? convexHull.face(fid) : nullptr;
+            f = locateFace(convexHull, start != nullptr ? start : lastFace, center, p);
+        }
+
+        if (!isFaceStrictlyVisible(f, p)){
+            //the point is inside the hull
+            locationCell(grid, p) = f->id();
+            lastFace = f;
+            continue;
+        }
+
+        visibleFacesFlooding(f, p, visibleFaces, stack);
+        horizonVertex.clear();
+        horizonEdges.clear();
+        horizonEdgeList(horizonEdges, visibleFaces, horizonVertex);
+        deleteVisibleFaces(convexHull, horizonVertex, visibleFaces);
+        insertNewFaces(convexHull, horizonEdges, p, newFaces);
+
+        locationCell(grid, p) = newFaces[0]->id();
+        lastFace = newFaces[0];
+    }
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,121 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <io/mapped_point_file.h>
+#include <utilities/system.h>
+
+namespace cg3 {
+
+namespace internal {
+
+/**
+ * @brief Approximate memory used by the hull engines for every input point: the point, its
+ * coordinates copy, its conflict lists and the Dcel elements created for it.
+ */
+static const unsigned long long outOfCoreBytesPerPoint = 256;
+
+/**
+ * @brief Replaces points with the vertices of their convex hull, computed with the algorithm
+ * of options (the vertices of their polygon, or the end points of their segment, if they are
+ * coplanar or collinear).
+ * @return false if the computation has been cancelled
+ */
+inline bool reduceToHullVertices(std::vector<Pointd>& points, const ConvexHullOptions& options)
+{
+    if (points.size() < 4)
+        return true;
+    Dcel ch;
+    if (!computeConvexHull(ch, points, options))
+        return false;
+    points.clear();
+    points.reserve(ch.numberVertices());
+    for (const Dcel::Vertex* v : ch.vertexIterator())
+        points.push_back(v->coordinate());
+    return true;
+}
+
+} //namespace cg3::internal
+
+/**
+ * @brief Computes the convex hull of the points of a binary point file (see io::MappedPointFile)
+ * which may be larger than the available memory.
+ *
+ * The file is memory-mapped and read in chunks: the hull of every chunk is computed with the
+ * algorithm of options, and only its vertices are kept. When the kept vertices exceed the
+ * memory limit, they are replaced by the vertices of their hull. The final hull is the hull of
+ * the kept vertices. The memory limit bounds the number of points that are processed at the
+ * same time (using an estimate of the memory used by the engines for every point), hence it
+ * cannot be respected if the hull itself has too many vertices.
+ *
+ * options.progress is called after every chunk with the number of points read from the file;
+ * options.cancel and options.deadline stop the computation as in convexHull.
+ *
+ * @param[in] filename: a binary point file
+ * @param[in] memoryLimit: the memory (in bytes) that can be used for the computation
+ * @param[in] options
+ * @param[out] statistics: if not nullptr, it is filled with the statistics of the computation,
+ * including the bytes read from the file and the peak memory of the process
+ * @return the convex hull, a triangle mesh (the flat hull of convexHull if the points are
+ * coplanar; empty if the file cannot be opened or the computation has been cancelled)
+ */
+inline Dcel convexHullOutOfCore(
+        const std::string& filename,
+        unsigned long long memoryLimit,
+        const ConvexHullOptions& options,
+        ConvexHullStatistics* statistics)
+{
+    Dcel convexHull;
+    io::MappedPointFile file(filename);
+    if (!file.isOpen())
+        return convexHull;
+
+    const unsigned long long maxPoints = std::max(memoryLimit / (2 * internal::outOfCoreBytesPerPoint), 1024ULL);
+    const unsigned long long nPoints = file.numberPoints();
+    unsigned long long bytesRead = 0;
+    unsigned long long nCulledPoints = 0;
+    bool completed = true;
+
+    //the progress of the hulls of the chunks is not reported: only the points read are
+    ConvexHullOptions chunkOptions = options;
+    chunkOptions.progress = nullptr;
+
+    std::vector<Pointd> chunk, candidates;
+    for (unsigned long long first = 0; first < nPoints && completed; first += maxPoints){
+        unsigned long long n = file.read(first, maxPoints, chunk);
+        bytesRead += n * sizeof(double[3]);
+
+        if (options.extremePointsFilter)
+            nCulledPoints += internal::extremePointsFilter(chunk);
+        completed = internal::reduceToHullVertices(chunk, chunkOptions);
+        candidates.insert(candidates.end(), chunk.begin(), chunk.end());
+
+        if (completed && candidates.size() > maxPoints)
+            completed = internal::reduceToHullVertices(candidates, chunkOptions);
+        if (completed && options.progress)
+            options.progress(first + n, nPoints);
+    }
+    std::vector<Pointd>().swap(chunk);
+
+    if (completed){
+        completed = internal::computeConvexHull(convexHull, candidates, chunkOptions);
+        convexHull.updateFaceNormals();
+        convexHull.updateVertexNormals();
+        convexHull.updateBoundingBox();
+    }
+
+    if (statistics != nullptr){
+        statistics->nInputPoints = nPoints;
+        statistics->nCulledPoints = nCulledPoints;
+        statistics->bytesRead = bytesRead;
+        statistics->peakMemory = peakMemoryUsage();
+        statistics->cancelled = !completed;
+    }
+    return convexHull;
+}
+
+} //namespace cg3
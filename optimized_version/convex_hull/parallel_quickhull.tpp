@@ -0,0 +1,199 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+#include <utilities/thread_pool.h>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief A point insertion of the parallel Quickhull: the farthest point pid of the outside
+ * set of the face fid, and the part of the hull that will be replaced by its insertion.
+ */
+struct QuickHullInsertion {
+    unsigned int fid;
+    unsigned int pid;
+    std::set<Dcel::Face*> visibleFaces;
+    std::set<Dcel::Vertex*> horizonVertex;
+    std::vector<Dcel::HalfEdge*> horizonEdges;
+    std::vector<Dcel::Face*> newFaces;
+    std::vector<unsigned int> outsidePoints;
+    std::vector<int> outsideFaces;
+    std::vector<Dcel::Face*> stack;
+};
+
+/**
+ * @brief Returns true if none of the faces visible by the insertion and none of the faces
+ * on the other side of its horizon is locked (in the current round), and if so it locks
+ * all of them.
+ */
+inline bool lockInsertionFaces(const QuickHullInsertion& ins, std::vector<unsigned int>& locks, unsigned int round)
+{
+    for (const Dcel::Face* f : ins.visibleFaces){
+        if (f->id() < locks.size() && locks[f->id()] == round)
+            return false;
+    }
+    for (const Dcel::HalfEdge* he : ins.horizonEdges){
+        if (he->face()->id() < locks.size() && locks[he->face()->id()] == round)
+            return false;
+    }
+    for (const Dcel::Face* f : ins.visibleFaces){
+        if (f->id() >= locks.size())
+            locks.resize(f->id()+1, 0);
+        locks[f->id()] = round;
+    }
+    for (const Dcel::HalfEdge* he : ins.horizonEdges){
+        if (he->face()->id() >= locks.size())
+            locks.resize(he->face()->id()+1, 0);
+        locks[he->face()->id()] = round;
+    }
+    return true;
+}
+
+/**
+ * @brief Parallel Quickhull: inserts in convexHull the hull of points.
+ *
+ * The algorithm proceeds in rounds. In every round:
+ * - for a number of faces with a non empty outside set, the farthest point, the visible
+ *   faces and the horizon are computed in parallel (the Dcel is only read);
+ * - the insertions are then accepted if they do not overlap: every accepted insertion locks
+ *   its visible faces and the faces on the other side of its horizon. The insertions
+ *   which touch a locked face are retried in the next round. Since the visible region of an
+ *   accepted insertion is not adjacent to the faces changed by the other accepted
+ *   insertions, it is still correct after they are applied;
+ * - the Dcel is updated (deleteVisibleFaces, insertNewFaces) by a single thread, which
+ *   takes a time proportional to the number of changed faces;
+ * - the points of the outside sets of the deleted faces are assigned to the new faces in
+ *   parallel.
+ *
+ * This is effective when the input has many well separated extreme regions, where many
+ * faces can be processed at the same time.
+ *
+ * @param[out] convexHull
+ * @param[in] points: the input points, which are reordered by the function
+ * @param[in] nThreads: number of threads; if 0, the number of hardware threads is used
+ * @param[in] control: if not nullptr, it is polled after every round, and the function returns
+ * with a partial hull when it must stop
+ */
+inline void parallelQuickHull(Dcel& convexHull, std::vector<Pointd>& points, unsigned int nThreads, ConvexHullControl* control)
+{
+    unsigned int nPoints = (unsigned int)points.size();
+    if (!insertInitialTet(convexHull, points))
+        return;
+
+    ThreadPool pool(nThreads);
+    const unsigned int maxInsertions = 4 * pool.numberThreads();
+
+    ConflictGraph cg(nPoints);
+    std::vector<Dcel::Face*> tetFaces;
+    for (Dcel::Face* f : convexHull.faceIterator()){
+        cg.addFace(f->id());
+        tetFaces.push_back(f);
+    }
+    std::vector<int> initialFaces(nPoints, -1);
+    pool.parallelFor(4, nPoints, [&](unsigned int i){
+        initialFaces[i] = outsideFace(tetFaces, points[i]);
+    });
+    unsigned int nProcessed = 4; //points inserted in the hull or discarded
+    for (unsigned int i = 4; i < nPoints; i++){
+        if (initialFaces[i] >= 0)
+            cg.addArc(i, tetFaces[initialFaces[i]]->id());
+        else
+            nProcessed++;
+    }
+    std::vector<int>().swap(initialFaces);
+
+    std::vector<unsigned int> pendingFaces, retryFaces;
+    for (Dcel::Face* f : tetFaces){
+        if (cg.sizeConflictsFace(f->id()) > 0)
+            pendingFaces.push_back(f->id());
+    }
+
+    std::vector<QuickHullInsertion> insertions(maxInsertions);
+    std::vector<unsigned int> locks;
+    std::vector<unsigned int> accepted;
+    unsigned int round = 0;
+
+    while (pendingFaces.size() > 0 && (control == nullptr || !control->poll(nProcessed))){
+        round++;
+
+        //faces processed in this round
+        unsigned int nInsertions = 0;
+        while (pendingFaces.size() > 0 && nInsertions < maxInsertions){
+            unsigned int fid = pendingFaces.back();
+            pendingFaces.pop_back();
+            //the face could have been deleted, or its id could have been reused
+            if (convexHull.face(fid) != nullptr && cg.sizeConflictsFace(fid) > 0)
+                insertions[nInsertions++].fid = fid;
+        }
+
+        //farthest points, visible faces and horizons (read only)
+        pool.parallelFor(0, nInsertions, [&](unsigned int i){
+            QuickHullInsertion& ins = insertions[i];
+            Dcel::Face* f = convexHull.face(ins.fid);
+            ins.pid = farthestPoint(cg, f, points);
+            visibleFacesFlooding(f, points[ins.pid], ins.visibleFaces, ins.stack);
+            ins.horizonVertex.clear();
+            ins.horizonEdges.clear();
+            horizonEdgeList(ins.horizonEdges, ins.visibleFaces, ins.horizonVertex);
+        });
+
+        //conflicts between insertions
+        accepted.clear();
+        for (unsigned int i = 0; i < nInsertions; i++){
+            if (lockInsertionFaces(insertions[i], locks, round))
+                accepted.push_back(i);
+            else
+                retryFaces.push_back(insertions[i].fid);
+        }
+
+        //update of the Dcel
+        for (unsigned int i : accepted){
+            QuickHullInsertion& ins = insertions[i];
+            ins.outsidePoints.clear();
+            for (Dcel::Face* g : ins.visibleFaces){
+                for (unsigned int q : cg.faceConflicts(g->id())){
+                    if (q != ins.pid)
+                        ins.outsidePoints.push_back(q);
+                }
+            }
+            cg.deletePoint(ins.pid);
+            deleteVisibleFaces(convexHull, ins.horizonVertex, ins.visibleFaces, cg);
+            insertNewFaces(convexHull, ins.horizonEdges, points[ins.pid], ins.newFaces);
+            for (Dcel::Face* nf : ins.newFaces)
+                cg.addFace(nf->id());
+        }
+
+        //new outside sets
+        pool.parallelFor(0, (unsigned int)accepted.size(), [&](unsigned int i){
+            QuickHullInsertion& ins = insertions[accepted[i]];
+            ins.outsideFaces.resize(ins.outsidePoints.size());
+            for (unsigned int j = 0; j < ins.outsidePoints.size(); j++)
+                ins.outsideFaces[j] = outsideFace(ins.newFaces, points[ins.outsidePoints[j]]);
+        });
+        for (unsigned int i : accepted){
+            QuickHullInsertion& ins = insertions[i];
+            nProcessed++;
+            for (unsigned int j = 0; j < ins.outsidePoints.size(); j++){
+                if (ins.outsideFaces[j] >= 0)
+                    cg.addArc(ins.outsidePoints[j], ins.newFaces[ins.outsideFaces[j]]->id());
+                else
+                    nProcessed++;
+            }
+            for (Dcel::Face* nf : ins.newFaces){
+                if (cg.sizeConflictsFace(nf->id()) > 0)
+                    pendingFaces.push_back(nf->id());
+            }
+        }
+        pendingFaces.insert(pendingFaces.end(), retryFaces.begin(), retryFaces.end());
+        retryFaces.clear();
+    }
+}
+
+} //namespace cg3::internal
+} //namespace cg3
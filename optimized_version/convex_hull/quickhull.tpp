@@ -0,0 +1,345 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Returns six times the signed volume of the tetrahedron composed of the face f
+ * and the point p. The value is positive if p lies outside the face, and, for a given
+ * face, it is proportional to the distance between p and the plane of the face.
+ */
+inline double outsideVolume(const Dcel::Face* f, const Pointd& p)
+{
+    Dcel::Face::ConstIncidentVertexIterator vit = f->incidentVertexBegin();
+    const Pointd& p1 = (*vit)->coordinate();
+    vit++;
+    const Pointd& p2 = (*vit)->coordinate();
+    vit++;
+    const Pointd& p3 = (*vit)->coordinate();
+    return -areCoplanar(p1, p2, p3, p);
+}
+
+/**
+ * @brief Returns the index of the point of the outside set of f which is farthest from f.
+ * The outside set of f must not be empty.
+ */
+inline unsigned int farthestPoint(const ConflictGraph& cg, const Dcel::Face* f, const std::vector<Pointd>& points)
+{
+    unsigned int pid = cg.faceConflicts(f->id())[0];
+    double maxVolume = outsideVolume(f, points[pid]);
+    for (unsigned int q : cg.faceConflicts(f->id())){
+        double v = outsideVolume(f, points[q]);
+        if (v > maxVolume){
+            maxVolume = v;
+            pid = q;
+        }
+    }
+    return pid;
+}
+
+/**
+ * @brief Computes the faces visible by p, flooding from the face f (which must be strictly
+ * visible by p): the faces strictly visible by p, extended with the faces that must be replaced
+ * with them (see extendVisibleFaces). stack is a support vector.
+ */
+inline void visibleFacesFlooding(Dcel::Face* f, const Pointd& p, std::set<Dcel::Face*>& visibleFaces, std::vector<Dcel::Face*>& stack)
+{
+    visibleFaces.clear();
+    visibleFaces.insert(f);
+    stack.push_back(f);
+    while (stack.size() > 0){
+        Dcel::Face* g = stack.back();
+        stack.pop_back();
+        for (Dcel::HalfEdge* he : g->incidentHalfEdgeIterator()){
+            Dcel::Face* adj = he->twin()->face();
+            if (visibleFaces.find(adj) == visibleFaces.end() && isFaceStrictlyVisible(adj, p)){
+                visibleFaces.insert(adj);
+                stack.push_back(adj);
+            }
+        }
+    }
+    stack.assign(visibleFaces.begin(), visibleFaces.end());
+    extendVisibleFaces(
+                stack,
+                p,
+                [&visibleFaces](Dcel::Face* g){ return visibleFaces.find(g) != visibleFaces.end(); },
+                [&visibleFaces, &stack](Dcel::Face* g){
+                    visibleFaces.insert(g);
+                    stack.push_back(g);
+                });
+}
+
+/**
+ * @brief Returns the position in newFaces of the first face which has p strictly outside,
+ * or -1 if p is inside (or on the plane of) all the faces.
+ */
+inline int outsideFace(const std::vector<Dcel::Face*>& newFaces, const Pointd& p)
+{
+    for (unsigned int i = 0; i < newFaces.size(); i++){
+        if (outsideVolume(newFaces[i], p) > 0)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns true if p lies strictly outside the face f, whose plane is cached in planes:
+ * the floating point filter of the plane decides almost all the points, and the exact
+ * predicate only the uncertain ones.
+ */
+inline bool isOutsideFacePlane(const FacePlanes& planes, const Dcel::Face* f, const Pointd& p)
+{
+    signed char side = planes.side(f->id(), p);
+    if (side != 0)
+        return side > 0;
+    const Dcel::HalfEdge* e = f->outerHalfEdge();
+    return orient3dExact(e->fromVertex()->coordinate(), e->toVertex()->coordinate(), e->next()->toVertex()->coordinate(), p) < 0;
+}
+
+/**
+ * @brief Computes in the visible faces of workspace the faces visible by the point pid of
+ * policy, flooding from the face f (which must be strictly visible by the point): the faces
+ * strictly visible by the point (policy.isOutside), extended with the faces that must be
+ * replaced with them (see addCoplanarFaces). A new insertion of workspace is started.
+ */
+template <class Policy>
+void quickHullVisibleFaces(ConvexHullWorkspace& workspace, const Policy& policy, Dcel::Face* f, unsigned int pid)
+{
+    std::vector<Dcel::Face*>& stack = workspace.stack;
+    workspace.startInsertion();
+    workspace.addVisibleFace(f);
+    stack.clear();
+    workspace.push(stack, f);
+    while (stack.size() > 0){
+        Dcel::Face* g = stack.back();
+        stack.pop_back();
+        for (Dcel::HalfEdge* he : g->incidentHalfEdgeIterator()){
+            Dcel::Face* adj = he->twin()->face();
+            if (!workspace.isVisible(adj) && policy.isOutside(adj, pid)){
+                workspace.addVisibleFace(adj);
+                workspace.push(stack, adj);
+            }
+        }
+    }
+    addCoplanarFaces(workspace, policy.point(pid));
+}
+
+/**
+ * @brief Pops from pendingFaces the next face f with a non empty outside set, and returns in
+ * pid its point with the largest distance(fid, pid).
+ * @return false if there are no faces left
+ */
+template <class Distance>
+bool nextFarthestPoint(
+        Dcel& convexHull,
+        const ConflictGraph& cg,
+        std::vector<unsigned int>& pendingFaces,
+        Distance distance,
+        Dcel::Face*& f,
+        unsigned int& pid)
+{
+    while (pendingFaces.size() > 0){
+        unsigned int fid = pendingFaces.back();
+        pendingFaces.pop_back();
+        f = convexHull.face(fid);
+        //the face could have been deleted, or its id could have been reused
+        if (f == nullptr || cg.sizeConflictsFace(fid) == 0)
+            continue;
+        pid = cg.faceConflicts(fid)[0];
+        auto maxDistance = distance(fid, pid);
+        for (unsigned int q : cg.faceConflicts(fid)){
+            auto d = distance(fid, q);
+            if (d > maxDistance){
+                maxDistance = d;
+                pid = q;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief The policy of quickHullLoop for an array of points with size() and operator[]
+ * returning a Pointd (a std::vector<Pointd>, or a StridedPointView whose points are converted
+ * on the fly). Every point is tested against the cached plane of a face (FacePlanes) with a
+ * static error bound, and only if the bound cannot certify the sign with the exact orient3d;
+ * the bound is valid for double coordinates whose differences and products neither overflow
+ * nor underflow. A point is assigned to the first new face that it sees, and the faces are
+ * processed in LIFO order, inserting the point farthest from the plane of the face.
+ */
+template <class PointArray>
+struct QuickHullPolicy {
+    QuickHullPolicy(Dcel& convexHull, const ConflictGraph& cg, const PointArray& points) :
+        convexHull(convexHull),
+        cg(cg),
+        points(points)
+    {
+    }
+
+    Pointd point(unsigned int pid) const
+    {
+        return points[pid];
+    }
+
+    bool isOutside(const Dcel::Face* f, unsigned int pid) const
+    {
+        return isOutsideFacePlane(planes, f, points[pid]);
+    }
+
+    void addFaces(const std::vector<Dcel::Face*>& faces)
+    {
+        for (const Dcel::Face* f : faces)
+            setFacePlane(planes, f);
+    }
+
+    int outsideFace(const std::vector<Dcel::Face*>& faces, unsigned int pid) const
+    {
+        for (unsigned int i = 0; i < faces.size(); i++){
+            if (isOutside(faces[i], pid))
+                return (int)i;
+        }
+        return -1;
+    }
+
+    void pushFace(const Dcel::Face* f)
+    {
+        if (cg.sizeConflictsFace(f->id()) > 0)
+            pendingFaces.push_back(f->id());
+    }
+
+    bool nextPoint(Dcel::Face*& f, unsigned int& pid)
+    {
+        return nextFarthestPoint(convexHull, cg, pendingFaces, [this](unsigned int fid, unsigned int q){
+            return planes.distance(fid, points[q]);
+        }, f, pid);
+    }
+
+    Dcel& convexHull;
+    const ConflictGraph& cg;
+    const PointArray& points;
+    FacePlanes planes;
+    std::vector<unsigned int> pendingFaces;
+};
+
+/**
+ * @brief The Quickhull loop, shared by quickHull and its variants: inserts in convexHull,
+ * which must contain the tetrahedron of the points simplex, the hull of the nPoints points of
+ * policy.
+ *
+ * The conflict graph of workspace stores the outside sets: every point is in conflict with at
+ * most one face (a face that it sees), and the points that do not see any face are discarded.
+ * At every step the policy chooses a face and a point of its outside set, which is inserted in
+ * the hull; the points of the outside sets of the deleted faces are then assigned to the new
+ * faces, or discarded. The visible faces, the horizon and the deleted vertices are the epoch
+ * marked buffers of workspace. The policy provides:
+ * - Pointd point(pid): the coordinates of a point;
+ * - bool isOutside(f, pid): true if the point is strictly outside the face (exact);
+ * - void addFaces(faces): called with the faces of the tetrahedron and with the new faces of
+ *   every insertion, before their outside sets are computed;
+ * - int outsideFace(faces, pid): the index of the face whose outside set gets the point, or -1
+ *   if the point is discarded;
+ * - void pushFace(f): called with every new face, after the computation of its outside set;
+ * - bool nextPoint(f, pid): the next face and point to insert, or false to stop.
+ * If control is not nullptr, it is polled after every step, and the function returns with a
+ * partial hull when it must stop. If indices is not nullptr, the flag of every inserted vertex
+ * is the index of its point.
+ */
+template <class Policy>
+void quickHullLoop(
+        Dcel& convexHull,
+        ConvexHullWorkspace& workspace,
+        Policy& policy,
+        unsigned int nPoints,
+        const unsigned int simplex[4],
+        ConvexHullControl* control,
+        const std::vector<unsigned int>* indices = nullptr)
+{
+    ConflictGraph& cg = workspace.cg;
+    std::vector<Dcel::Face*>& newFaces = workspace.newFaces;
+    cg.reset(nPoints);
+    newFaces.clear();
+    for (Dcel::Face* f : convexHull.faceIterator()){
+        cg.addFace(f->id());
+        newFaces.push_back(f);
+    }
+    policy.addFaces(newFaces);
+    unsigned int nProcessed = 4; //points inserted in the hull or discarded
+    for (unsigned int i = 0; i < nPoints; i++){
+        if (i == simplex[0] || i == simplex[1] || i == simplex[2] || i == simplex[3])
+            continue;
+        int j = policy.outsideFace(newFaces, i);
+        if (j >= 0)
+            cg.addArc(i, newFaces[j]->id());
+        else
+            nProcessed++;
+    }
+    for (Dcel::Face* f : newFaces)
+        policy.pushFace(f);
+
+    std::vector<unsigned int> outsidePoints;
+    Dcel::Face* f;
+    unsigned int pid;
+    while ((control == nullptr || !control->poll(nProcessed)) && policy.nextPoint(f, pid)){
+        const Pointd p = policy.point(pid);
+        quickHullVisibleFaces(workspace, policy, f, pid);
+
+        //points that must be assigned to the new faces
+        outsidePoints.clear();
+        for (Dcel::Face* g : workspace.visibleFaces){
+            for (unsigned int q : cg.faceConflicts(g->id())){
+                if (q != pid)
+                    outsidePoints.push_back(q);
+            }
+        }
+
+        horizonEdgeList(workspace);
+        cg.deletePoint(pid);
+        deleteVisibleFaces(convexHull, workspace);
+        insertNewFaces(convexHull, workspace.horizonEdges, p, newFaces);
+        if (indices != nullptr)
+            newFacesApex(newFaces)->setFlag((*indices)[pid]);
+
+        for (Dcel::Face* nf : newFaces)
+            cg.addFace(nf->id());
+        policy.addFaces(newFaces);
+        nProcessed++;
+        for (unsigned int q : outsidePoints){
+            int i = policy.outsideFace(newFaces, q);
+            if (i >= 0)
+                cg.addArc(q, newFaces[i]->id());
+            else
+                nProcessed++;
+        }
+        for (Dcel::Face* nf : newFaces)
+            policy.pushFace(nf);
+    }
+}
+
+/**
+ * @brief Quickhull: inserts in convexHull the hull of points, with quickHullLoop and a
+ * QuickHullPolicy: at every step a face with a non empty outside set is taken, and its
+ * farthest point is inserted in the hull.
+ * If control is not nullptr, it is polled after every step, and the function returns with a
+ * partial hull when it must stop. If indices is not nullptr, it is an array parallel to points
+ * (see insertInitialTet), and the flag of every vertex of the hull is the index of its point.
+ */
+inline void quickHull(Dcel& convexHull, std::vector<Pointd>& points, ConvexHullControl* control, std::vector<unsigned int>* indices)
+{
+    if (!insertInitialTet(convexHull, points, indices))
+        return;
+    ConvexHullWorkspace workspace;
+    QuickHullPolicy<std::vector<Pointd> > policy(convexHull, workspace.cg, points);
+    const unsigned int simplex[4] = {0, 1, 2, 3};
+    quickHullLoop(convexHull, workspace, policy, (unsigned int)points.size(), simplex, control, indices);
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,70 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "convexhull.h"
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Quickhull on an array of points read in place: inserts in convexHull the hull of
+ * points, which can be any array with size() and operator[] returning a Pointd (e.g. a
+ * StridedPointView of floats, whose points are converted on the fly). The points are never
+ * copied or moved: the conflict graph refers to their positions in the array.
+ *
+ * This is quickHullLoop with a QuickHullPolicy on the array: its static error bound is always
+ * valid for float coordinates, whose differences and products can neither overflow nor
+ * underflow in double precision. If the points are coplanar, convexHull is left empty.
+ */
+template <class PointArray>
+void stridedQuickHull(Dcel& convexHull, const PointArray& points, ConvexHullControl* control)
+{
+    unsigned int simplex[4];
+    if (findInitialSimplex(points, simplex) < 4)
+        return;
+    Pointd s[4] = {points[simplex[0]], points[simplex[1]], points[simplex[2]], points[simplex[3]]};
+    if (areCoplanar(s[0], s[1], s[2], s[3]) > 0)
+        insertTet(convexHull, s[0], s[1], s[2], s[3]);
+    else
+        insertTet(convexHull, s[1], s[0], s[2], s[3]);
+
+    ConvexHullWorkspace workspace;
+    QuickHullPolicy<PointArray> policy(convexHull, workspace.cg, points);
+    quickHullLoop(convexHull, workspace, policy, points.size(), simplex, control);
+}
+
+/**
+ * @brief Computes the hull of an array of points read in place with stridedQuickHull (or, if
+ * they are coplanar, with insertFlatHull), and fills statistics (if not nullptr).
+ * @return false if the computation has been cancelled (convexHull is then empty)
+ */
+template <class PointArray>
+bool computeStridedConvexHull(Dcel& convexHull, const PointArray& points, const ConvexHullOptions& options, ConvexHullStatistics* statistics)
+{
+    ConvexHullControl control(options.progress, options.deadline, options.cancel, points.size());
+    if (statistics != nullptr){
+        *statistics = ConvexHullStatistics();
+        statistics->nInputPoints = points.size();
+    }
+    bool completed = !control.mustStop();
+    if (completed)
+        stridedQuickHull(convexHull, points, &control);
+    if (control.isStopped()){
+        convexHull.clear();
+        completed = false;
+    }
+    else if (convexHull.numberVertices() == 0)
+        insertFlatHull(convexHull, points);
+    if (completed)
+        control.finish();
+    if (statistics != nullptr)
+        statistics->cancelled = !completed;
+    return completed;
+}
+
+} //namespace cg3::internal
+} //namespace cg3
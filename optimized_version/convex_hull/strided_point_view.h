@@ -0,0 +1,48 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_CONVEXHULL_STRIDED_POINT_VIEW_H
+#define CG3_CONVEXHULL_STRIDED_POINT_VIEW_H
+
+#include <cstddef>
+#include <geometry/point.h>
+
+namespace cg3 {
+
+/**
+ * @brief The StridedPointView class reads in place an array of points whose coordinates are
+ * stored by someone else, without copying them: the coordinates x, y and z of every point are
+ * consecutive values of type Scalar (float or double), and consecutive points are byteStride
+ * bytes apart. It can view raw triplets (byteStride = 3 * sizeof(Scalar)), interleaved vertex
+ * buffers and arrays of Point<Scalar>.
+ *
+ * The points are returned as Pointd, converted on the fly: the conversion from float is exact.
+ * The viewed memory must outlive the view, and must not change while a hull is computed.
+ */
+template <class Scalar>
+class StridedPointView
+{
+public:
+    StridedPointView();
+    StridedPointView(const Scalar* coordinates, unsigned int nPoints, std::size_t byteStride = 3 * sizeof(Scalar));
+    StridedPointView(const Point<Scalar>* points, unsigned int nPoints);
+
+    unsigned int size() const;
+    const Scalar* coordinates(unsigned int i) const;
+    Pointd operator[](unsigned int i) const;
+
+protected:
+    const unsigned char* data;
+    unsigned int nPoints;
+    std::size_t byteStride;
+};
+
+} //namespace cg3
+
+#include "strided_point_view.tpp"
+
+#endif // CG3_CONVEXHULL_STRIDED_POINT_VIEW_H
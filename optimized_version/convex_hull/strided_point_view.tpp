@@ -0,0 +1,88 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "strided_point_view.h"
+
+namespace cg3 {
+
+/**
+ * @brief StridedPointView::StridedPointView
+ * Default constructor. It creates an empty view.
+ */
+template <class Scalar>
+StridedPointView<Scalar>::StridedPointView() :
+    data(nullptr),
+    nPoints(0),
+    byteStride(3 * sizeof(Scalar))
+{
+}
+
+/**
+ * @brief StridedPointView::StridedPointView
+ * Creates a view of nPoints points: the coordinates of the point i are
+ * coordinates[0], coordinates[1] and coordinates[2] of the address coordinates + i * byteStride
+ * (in bytes).
+ * @param[in] coordinates: the coordinates of the first point
+ * @param[in] nPoints
+ * @param[in] byteStride: distance in bytes between consecutive points (default: packed triplets)
+ */
+template <class Scalar>
+StridedPointView<Scalar>::StridedPointView(const Scalar* coordinates, unsigned int nPoints, std::size_t byteStride) :
+    data(reinterpret_cast<const unsigned char*>(coordinates)),
+    nPoints(nPoints),
+    byteStride(byteStride)
+{
+}
+
+/**
+ * @brief StridedPointView::StridedPointView
+ * Creates a view of an array of nPoints Point<Scalar>.
+ * @param[in] points
+ * @param[in] nPoints
+ */
+template <class Scalar>
+StridedPointView<Scalar>::StridedPointView(const Point<Scalar>* points, unsigned int nPoints) :
+    data(nPoints > 0 ? reinterpret_cast<const unsigned char*>(&points[0].x()) : nullptr),
+    nPoints(nPoints),
+    byteStride(sizeof(Point<Scalar>))
+{
+}
+
+/**
+ * @brief StridedPointView::size
+ * @return the number of points
+ */
+template <class Scalar>
+unsigned int StridedPointView<Scalar>::size() const
+{
+    return nPoints;
+}
+
+/**
+ * @brief StridedPointView::coordinates
+ * @param[in] i
+ * @return the address of the three coordinates of the point i
+ */
+template <class Scalar>
+const Scalar* StridedPointView<Scalar>::coordinates(unsigned int i) const
+{
+    return reinterpret_cast<const Scalar*>(data + i * byteStride);
+}
+
+/**
+ * @brief StridedPointView::operator []
+ * @param[in] i
+ * @return the point i, converted to Pointd
+ */
+template <class Scalar>
+Pointd StridedPointView<Scalar>::operator[](unsigned int i) const
+{
+    const Scalar* c = coordinates(i);
+    return Pointd(c[0], c[1], c[2]);
+}
+
+} //namespace cg3
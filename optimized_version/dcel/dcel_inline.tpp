@@ -92,6 +92,46 @@ inline unsigned int Dcel::numberFaces () const
     return nFaces;
 }
 
+/**
+ * @return The number of vertex ids allocated in the Dcel, used or not: the id of every vertex
+ * is smaller than this number, and vertex(id) returns nullptr for the unused ids.
+ */
+inline unsigned int Dcel::numberVertexSlots() const
+{
+    return (unsigned int)vertices.size();
+}
+
+/**
+ * @return The number of half edge ids allocated in the Dcel, used or not (see
+ * numberVertexSlots).
+ */
+inline unsigned int Dcel::numberHalfEdgeSlots() const
+{
+    return (unsigned int)halfEdges.size();
+}
+
+/**
+ * @return The number of face ids allocated in the Dcel, used or not (see numberVertexSlots).
+ */
+inline unsigned int Dcel::numberFaceSlots() const
+{
+    return (unsigned int)faces.size();
+}
+
+#ifdef NDEBUG
+/**
+ * @brief Returns the array of the coordinates of the vertices, indexed by their ids. The slots
+ * of the unused ids (see numberVertexSlots) contain meaningless coordinates.
+ * @return The contiguous array of the vertex coordinates
+ * @par Complexity:
+ *      \e O(1)
+ */
+inline const std::vector<Pointd>& Dcel::vertexCoordinateArray() const
+{
+    return vertexCoordinates;
+}
+#endif
+
 /**
  * @param[in] v: a pointer to a Vertex
  * @return true if the vertex belongs to this Dcel, false otherwise
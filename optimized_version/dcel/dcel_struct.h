@@ -120,6 +120,12 @@ public:
     inline unsigned int numberVertices()        const;
     inline unsigned int numberHalfEdges()       const;
     inline unsigned int numberFaces()           const;
+    inline unsigned int numberVertexSlots()     const;
+    inline unsigned int numberHalfEdgeSlots()   const;
+    inline unsigned int numberFaceSlots()       const;
+    #ifdef NDEBUG
+    inline const std::vector<Pointd>& vertexCoordinateArray() const;
+    #endif
     inline bool contains(const Vertex* v)               const;
     inline bool contains(const HalfEdge* he)            const;
     inline bool contains(const Face* f)                 const;
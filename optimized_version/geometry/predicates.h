@@ -0,0 +1,42 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_PREDICATES_H
+#define CG3_PREDICATES_H
+
+#include <geometry/point.h>
+#include <geometry/2d/point2d.h>
+
+namespace cg3 {
+
+inline double orient2d(
+        const Point2Dd& a,
+        const Point2Dd& b,
+        const Point2Dd& c);
+
+inline double orient2dExact(
+        const Point2Dd& a,
+        const Point2Dd& b,
+        const Point2Dd& c);
+
+inline double orient3d(
+        const Pointd& a,
+        const Pointd& b,
+        const Pointd& c,
+        const Pointd& d);
+
+inline double orient3dExact(
+        const Pointd& a,
+        const Pointd& b,
+        const Pointd& c,
+        const Pointd& d);
+
+} //namespace cg3
+
+#include "predicates.tpp"
+
+#endif // CG3_PREDICATES_H
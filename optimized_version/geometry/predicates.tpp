@@ -0,0 +1,341 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "predicates.h"
+
+#include <cmath>
+#include <assert.h>
+
+namespace cg3 {
+
+namespace internal {
+
+/*
+ * Floating point expansions (J. R. Shewchuk, "Adaptive Precision Floating-Point
+ * Arithmetic and Fast Robust Geometric Predicates", 1997).
+ *
+ * An expansion is an array of doubles, sorted by increasing magnitude and not
+ * overlapping, whose exact sum is the represented value. All the functions
+ * require IEEE 754 double precision with round to nearest: the project must not
+ * be compiled with -ffast-math or with x87 extended precision.
+ */
+
+static const double predicatesEpsilon = 1.1102230246251565e-16; //2^-53
+static const double predicatesSplitter = 134217729.0; //2^27 + 1
+static const double orient2dErrorBound = (3.0 + 16.0 * predicatesEpsilon) * predicatesEpsilon;
+static const double orient3dErrorBound = (7.0 + 56.0 * predicatesEpsilon) * predicatesEpsilon;
+
+inline void fastTwoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bVirtual = x - a;
+    y = b - bVirtual;
+}
+
+inline void twoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bVirtual = x - a;
+    double aVirtual = x - bVirtual;
+    double bRoundoff = b - bVirtual;
+    double aRoundoff = a - aVirtual;
+    y = aRoundoff + bRoundoff;
+}
+
+inline void twoDiff(double a, double b, double& x, double& y)
+{
+    x = a - b;
+    double bVirtual = a - x;
+    double aVirtual = x + bVirtual;
+    double bRoundoff = bVirtual - b;
+    double aRoundoff = a - aVirtual;
+    y = aRoundoff + bRoundoff;
+}
+
+inline void split(double a, double& hi, double& lo)
+{
+    double c = predicatesSplitter * a;
+    double aBig = c - a;
+    hi = c - aBig;
+    lo = a - hi;
+}
+
+inline void twoProduct(double a, double b, double& x, double& y)
+{
+    x = a * b;
+    double aHi, aLo, bHi, bLo;
+    split(a, aHi, aLo);
+    split(b, bHi, bLo);
+    double err1 = x - (aHi * bHi);
+    double err2 = err1 - (aLo * bHi);
+    double err3 = err2 - (aHi * bLo);
+    y = (aLo * bLo) - err3;
+}
+
+/**
+ * @brief Computes the exact difference a - b as an expansion of one or two components.
+ * @return the length of h
+ */
+inline int twoDiffExpansion(double a, double b, double* h)
+{
+    double x, y;
+    twoDiff(a, b, x, y);
+    if (y == 0){
+        h[0] = x;
+        return 1;
+    }
+    h[0] = y;
+    h[1] = x;
+    return 2;
+}
+
+/**
+ * @brief h = e * b, with zero elimination. h must have room for 2*elen components.
+ * @return the length of h
+ */
+inline int scaleExpansion(int elen, const double* e, double b, double* h)
+{
+    double q, hh, product1, product0, sum;
+    int hIndex = 0;
+    twoProduct(e[0], b, q, hh);
+    if (hh != 0)
+        h[hIndex++] = hh;
+    for (int i = 1; i < elen; i++){
+        twoProduct(e[i], b, product1, product0);
+        twoSum(q, product0, sum, hh);
+        if (hh != 0)
+            h[hIndex++] = hh;
+        fastTwoSum(product1, sum, q, hh);
+        if (hh != 0)
+            h[hIndex++] = hh;
+    }
+    if (q != 0 || hIndex == 0)
+        h[hIndex++] = q;
+    return hIndex;
+}
+
+/**
+ * @brief h = e + f, with zero elimination. h must have room for elen + flen components.
+ * @return the length of h
+ */
+inline int sumExpansions(int elen, const double* e, int flen, const double* f, double* h)
+{
+    double q, qNew, hh;
+    int eIndex = 0, fIndex = 0, hIndex = 0;
+    double eNow = e[0];
+    double fNow = f[0];
+    if ((fNow > eNow) == (fNow > -eNow)){
+        q = eNow;
+        eIndex++;
+    }
+    else {
+        q = fNow;
+        fIndex++;
+    }
+    while (eIndex < elen && fIndex < flen){
+        eNow = e[eIndex];
+        fNow = f[fIndex];
+        if ((fNow > eNow) == (fNow > -eNow)){
+            twoSum(q, eNow, qNew, hh);
+            eIndex++;
+        }
+        else {
+            twoSum(q, fNow, qNew, hh);
+            fIndex++;
+        }
+        q = qNew;
+        if (hh != 0)
+            h[hIndex++] = hh;
+    }
+    for (; eIndex < elen; eIndex++){
+        twoSum(q, e[eIndex], qNew, hh);
+        q = qNew;
+        if (hh != 0)
+            h[hIndex++] = hh;
+    }
+    for (; fIndex < flen; fIndex++){
+        twoSum(q, f[fIndex], qNew, hh);
+        q = qNew;
+        if (hh != 0)
+            h[hIndex++] = hh;
+    }
+    if (q != 0 || hIndex == 0)
+        h[hIndex++] = q;
+    return hIndex;
+}
+
+/**
+ * @brief h = e * f, where f has at most two components. e can have at most 16
+ * components, and h must have room for 4*elen components.
+ * @return the length of h
+ */
+inline int multiplyExpansions(int elen, const double* e, int flen, const double* f, double* h)
+{
+    assert(elen <= 16 && flen <= 2);
+    double t0[32], t1[32];
+    int t0len = scaleExpansion(elen, e, f[0], t0);
+    if (flen == 1){
+        for (int i = 0; i < t0len; i++)
+            h[i] = t0[i];
+        return t0len;
+    }
+    int t1len = scaleExpansion(elen, e, f[1], t1);
+    return sumExpansions(t0len, t0, t1len, t1, h);
+}
+
+/**
+ * @brief h = a * (b1 * c1 - b2 * c2), where all the factors have at most two
+ * components. h must have room for 64 components.
+ * @return the length of h
+ */
+inline int orient3dTerm(
+        int alen, const double* a,
+        int b1len, const double* b1, int c1len, const double* c1,
+        int b2len, const double* b2, int c2len, const double* c2,
+        double* h)
+{
+    double m1[8], m2[8], s[16];
+    int m1len = multiplyExpansions(b1len, b1, c1len, c1, m1);
+    int m2len = multiplyExpansions(b2len, b2, c2len, c2, m2);
+    for (int i = 0; i < m2len; i++)
+        m2[i] = -m2[i];
+    int slen = sumExpansions(m1len, m1, m2len, m2, s);
+    return multiplyExpansions(slen, s, alen, a, h);
+}
+
+} //namespace cg3::internal
+
+/**
+ * @ingroup cg3core
+ * @brief Orientation predicate in 2D: returns a positive value if a, b and c are in
+ * counterclockwise order, a negative value if they are in clockwise order, and zero if they
+ * are collinear.
+ *
+ * As for orient3d, the returned value approximates the determinant of the matrix whose rows
+ * are a-c and b-c (twice the signed area of the triangle abc), but its sign is always exact:
+ * the floating point result is accepted when it exceeds a static error bound, otherwise it is
+ * recomputed exactly by orient2dExact.
+ *
+ * @param[in] a
+ * @param[in] b
+ * @param[in] c
+ * @return a value with the sign of the orientation of abc
+ */
+inline double orient2d(const Point2Dd& a, const Point2Dd& b, const Point2Dd& c)
+{
+    double detLeft = (a.x() - c.x()) * (b.y() - c.y());
+    double detRight = (a.y() - c.y()) * (b.x() - c.x());
+    double det = detLeft - detRight;
+    double errorBound = internal::orient2dErrorBound * (std::fabs(detLeft) + std::fabs(detRight));
+    if (det > errorBound || -det > errorBound)
+        return det;
+    return orient2dExact(a, b, c);
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Computes exactly the orientation of abc (see orient2d), using floating point
+ * expansions.
+ * @param[in] a
+ * @param[in] b
+ * @param[in] c
+ * @return the most significant component of the exact determinant
+ */
+inline double orient2dExact(const Point2Dd& a, const Point2Dd& b, const Point2Dd& c)
+{
+    double acx[2], bcy[2], acy[2], bcx[2];
+    int acxlen = internal::twoDiffExpansion(a.x(), c.x(), acx);
+    int bcylen = internal::twoDiffExpansion(b.y(), c.y(), bcy);
+    int acylen = internal::twoDiffExpansion(a.y(), c.y(), acy);
+    int bcxlen = internal::twoDiffExpansion(b.x(), c.x(), bcx);
+
+    double left[8], right[8], det[16];
+    int leftlen = internal::multiplyExpansions(acxlen, acx, bcylen, bcy, left);
+    int rightlen = internal::multiplyExpansions(acylen, acy, bcxlen, bcx, right);
+    for (int i = 0; i < rightlen; i++)
+        right[i] = -right[i];
+    int detlen = internal::sumExpansions(leftlen, left, rightlen, right, det);
+    return det[detlen - 1];
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Orientation predicate: returns a positive value if d lies below the plane passing
+ * through a, b and c (where "below" is defined so that a, b and c appear in counterclockwise
+ * order when seen from above the plane), a negative value if d lies above the plane, and
+ * zero if the four points are coplanar.
+ *
+ * The returned value is an approximation of the determinant of the matrix whose rows are
+ * a-d, b-d and c-d (six times the signed volume of the tetrahedron abcd), but its sign is
+ * always exact. The determinant is first computed in floating point, and its sign is
+ * accepted if the absolute value is greater than an error bound computed from the
+ * magnitude of the products; only in the other (rare) cases the determinant is computed
+ * exactly by orient3dExact.
+ *
+ * @param[in] a
+ * @param[in] b
+ * @param[in] c
+ * @param[in] d
+ * @return a value with the sign of the orientation of abcd
+ */
+inline double orient3d(const Pointd& a, const Pointd& b, const Pointd& c, const Pointd& d)
+{
+    double adx = a.x() - d.x(), bdx = b.x() - d.x(), cdx = c.x() - d.x();
+    double ady = a.y() - d.y(), bdy = b.y() - d.y(), cdy = c.y() - d.y();
+    double adz = a.z() - d.z(), bdz = b.z() - d.z(), cdz = c.z() - d.z();
+
+    double bdxcdy = bdx * cdy;
+    double cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady;
+    double adxcdy = adx * cdy;
+    double adxbdy = adx * bdy;
+    double bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent =
+            (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz) +
+            (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz) +
+            (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+    double errorBound = internal::orient3dErrorBound * permanent;
+    if (det > errorBound || -det > errorBound)
+        return det;
+    return orient3dExact(a, b, c, d);
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Computes exactly the orientation of abcd (see orient3d), using floating point
+ * expansions. It is much slower than orient3d, which calls it only when needed.
+ * @param[in] a
+ * @param[in] b
+ * @param[in] c
+ * @param[in] d
+ * @return the most significant component of the exact determinant
+ */
+inline double orient3dExact(const Pointd& a, const Pointd& b, const Pointd& c, const Pointd& d)
+{
+    double adx[2], bdx[2], cdx[2], ady[2], bdy[2], cdy[2], adz[2], bdz[2], cdz[2];
+    int adxlen = internal::twoDiffExpansion(a.x(), d.x(), adx);
+    int bdxlen = internal::twoDiffExpansion(b.x(), d.x(), bdx);
+    int cdxlen = internal::twoDiffExpansion(c.x(), d.x(), cdx);
+    int adylen = internal::twoDiffExpansion(a.y(), d.y(), ady);
+    int bdylen = internal::twoDiffExpansion(b.y(), d.y(), bdy);
+    int cdylen = internal::twoDiffExpansion(c.y(), d.y(), cdy);
+    int adzlen = internal::twoDiffExpansion(a.z(), d.z(), adz);
+    int bdzlen = internal::twoDiffExpansion(b.z(), d.z(), bdz);
+    int cdzlen = internal::twoDiffExpansion(c.z(), d.z(), cdz);
+
+    double t1[64], t2[64], t3[64], t12[128], det[192];
+    int t1len = internal::orient3dTerm(adzlen, adz, bdxlen, bdx, cdylen, cdy, cdxlen, cdx, bdylen, bdy, t1);
+    int t2len = internal::orient3dTerm(bdzlen, bdz, cdxlen, cdx, adylen, ady, adxlen, adx, cdylen, cdy, t2);
+    int t3len = internal::orient3dTerm(cdzlen, cdz, adxlen, adx, bdylen, bdy, bdxlen, bdx, adylen, ady, t3);
+    int t12len = internal::sumExpansions(t1len, t1, t2len, t2, t12);
+    int detlen = internal::sumExpansions(t12len, t12, t3len, t3, det);
+    return det[detlen - 1];
+}
+
+} //namespace cg3
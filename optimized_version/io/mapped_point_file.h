@@ -0,0 +1,65 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_MAPPED_POINT_FILE_H
+#define CG3_MAPPED_POINT_FILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "../geometry/point.h"
+
+namespace cg3 {
+namespace io {
+
+/**
+ * @brief The MappedPointFile class gives read access to a binary point file without loading
+ * it in memory.
+ *
+ * A binary point file is a sequence of points, each one stored as three doubles (x, y, z)
+ * in the byte order of the machine, without any header. On POSIX systems the file is
+ * memory-mapped, and the pages of every read range are released right after the copy, so
+ * that the resident memory does not grow with the size of the file; on the other systems
+ * the ranges are read with a std::ifstream.
+ */
+class MappedPointFile
+{
+public:
+    MappedPointFile();
+    MappedPointFile(const std::string& filename);
+    ~MappedPointFile();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+
+    unsigned long long numberPoints() const;
+    unsigned long long read(unsigned long long first, unsigned long long n, std::vector<Pointd>& points);
+
+private:
+    MappedPointFile(const MappedPointFile&);
+    MappedPointFile& operator=(const MappedPointFile&);
+
+    unsigned long long nPoints;
+    #ifdef _WIN32
+    std::ifstream file;
+    bool opened;
+    #else
+    int fd;
+    const double* data;
+    unsigned long long mappedSize;
+    #endif
+};
+
+bool savePointsOnBinaryFile(const std::string& filename, const std::vector<Pointd>& points);
+
+} //namespace cg3::io
+} //namespace cg3
+
+#include "mapped_point_file.tpp"
+
+#endif // CG3_MAPPED_POINT_FILE_H
@@ -0,0 +1,191 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "mapped_point_file.h"
+
+#include <algorithm>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cg3 {
+namespace io {
+
+/**
+ * @brief MappedPointFile::MappedPointFile
+ * Default constructor. No file is opened.
+ */
+inline MappedPointFile::MappedPointFile() :
+    nPoints(0),
+    #ifdef _WIN32
+    opened(false)
+    #else
+    fd(-1),
+    data(nullptr),
+    mappedSize(0)
+    #endif
+{
+}
+
+/**
+ * @brief MappedPointFile::MappedPointFile
+ * Opens the binary point file filename. Use isOpen() to check if the file has been opened.
+ * @param[in] filename
+ */
+inline MappedPointFile::MappedPointFile(const std::string& filename) :
+    MappedPointFile()
+{
+    open(filename);
+}
+
+inline MappedPointFile::~MappedPointFile()
+{
+    close();
+}
+
+/**
+ * @brief MappedPointFile::open
+ * Opens the binary point file filename, closing the previously opened file.
+ * Trailing bytes that do not form a whole point are ignored.
+ * @param[in] filename
+ * @return true if the file has been opened
+ */
+inline bool MappedPointFile::open(const std::string& filename)
+{
+    close();
+    #ifdef _WIN32
+    file.open(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    nPoints = (unsigned long long)file.tellg() / sizeof(double[3]);
+    opened = true;
+    #else
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0){
+        close();
+        return false;
+    }
+    nPoints = (unsigned long long)st.st_size / sizeof(double[3]);
+    mappedSize = nPoints * sizeof(double[3]);
+    if (mappedSize > 0){
+        void* map = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED){
+            close();
+            return false;
+        }
+        madvise(map, mappedSize, MADV_SEQUENTIAL);
+        data = (const double*)map;
+    }
+    #endif
+    return true;
+}
+
+/**
+ * @brief MappedPointFile::close
+ * Closes the file (if opened).
+ */
+inline void MappedPointFile::close()
+{
+    #ifdef _WIN32
+    if (opened)
+        file.close();
+    opened = false;
+    #else
+    if (data != nullptr)
+        munmap((void*)data, mappedSize);
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    data = nullptr;
+    mappedSize = 0;
+    #endif
+    nPoints = 0;
+}
+
+inline bool MappedPointFile::isOpen() const
+{
+    #ifdef _WIN32
+    return opened;
+    #else
+    return fd >= 0;
+    #endif
+}
+
+/**
+ * @brief MappedPointFile::numberPoints
+ * @return the number of points of the file
+ */
+inline unsigned long long MappedPointFile::numberPoints() const
+{
+    return nPoints;
+}
+
+/**
+ * @brief MappedPointFile::read
+ * Replaces the content of points with the points of the file in the range [first, first+n)
+ * (clamped to the end of the file).
+ * @param[in] first: index of the first point to read
+ * @param[in] n: number of points to read
+ * @param[out] points
+ * @return the number of points read
+ */
+inline unsigned long long MappedPointFile::read(unsigned long long first, unsigned long long n, std::vector<Pointd>& points)
+{
+    points.clear();
+    if (first >= nPoints)
+        return 0;
+    n = std::min(n, nPoints - first);
+    points.resize(n);
+    #ifdef _WIN32
+    std::vector<double> buffer(3*n);
+    file.seekg(first * sizeof(double[3]));
+    file.read((char*)buffer.data(), n * sizeof(double[3]));
+    const double* p = buffer.data();
+    #else
+    const double* p = data + 3*first;
+    #endif
+    for (unsigned long long i = 0; i < n; i++)
+        points[i] = Pointd(p[3*i], p[3*i+1], p[3*i+2]);
+
+    #ifndef _WIN32
+    //the pages of the range are not needed anymore: they can be dropped from the resident memory
+    const unsigned long long pageSize = (unsigned long long)sysconf(_SC_PAGESIZE);
+    unsigned long long begin = first * sizeof(double[3]) / pageSize * pageSize;
+    unsigned long long end = (first + n) * sizeof(double[3]) / pageSize * pageSize;
+    if (end > begin)
+        madvise((char*)data + begin, end - begin, MADV_DONTNEED);
+    #endif
+    return n;
+}
+
+/**
+ * @brief savePointsOnBinaryFile
+ * Saves points in a binary point file (see MappedPointFile).
+ * @param[in] filename
+ * @param[in] points
+ * @return true if the file has been written
+ */
+inline bool savePointsOnBinaryFile(const std::string& filename, const std::vector<Pointd>& points)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    for (const Pointd& p : points){
+        double c[3] = {p.x(), p.y(), p.z()};
+        file.write((const char*)c, sizeof(c));
+    }
+    return file.good();
+}
+
+} //namespace cg3::io
+} //namespace cg3
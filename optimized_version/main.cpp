@@ -7,19 +7,35 @@
 #include <iostream>
 
 #include "convex_hull/convexhull.h"
+#include "convex_hull/convexhull_cache.h"
 #include "utilities/timer.h"
 
 int main(int argc, char* argv[])
 {
-    if (argc != 3) {
-        std::cerr << "Usage: ConvexHull3D input_mesh_name.obj output_mesh_name.obj";
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: ConvexHull3D input_mesh_name.obj output_mesh_name.obj [cache_directory]";
     }
     else {
         cg3::Dcel d(argv[1]);
 
         cg3::Timer chTimer("Convex Hull");
-        cg3::Dcel ch = cg3::convexHull(d);
-        chTimer.stopAndPrint();
+        cg3::Dcel ch;
+        if (argc == 4) {
+            std::vector<cg3::Pointd> points;
+            points.reserve(d.numberVertices());
+            for (const cg3::Dcel::Vertex* v : d.vertexIterator())
+                points.push_back(v->coordinate());
+
+            cg3::ConvexHullCache cache(argv[3]);
+            ch = cache.convexHull(points);
+            chTimer.stopAndPrint();
+            std::cout << "Cache: " << cache.numberHits() << " hits, " << cache.numberMisses() << " misses, "
+                      << cache.numberEntries() << " entries (" << cache.size() << " bytes)\n";
+        }
+        else {
+            ch = cg3::convexHull(d);
+            chTimer.stopAndPrint();
+        }
 
         ch.saveOnObj(argv[2]);
     }
@@ -22,6 +22,29 @@ bool executeCommand(const std::string& cmd, std::string& output);
 
 bool executeCommand(const char* cmd, std::string& output);
 
+unsigned long long peakMemoryUsage();
+
+/**
+ * @brief The CacheMissCounter class counts the hardware cache misses of the process (including
+ * the threads created after start()), where the performance counters are available (Linux).
+ */
+class CacheMissCounter
+{
+public:
+    CacheMissCounter();
+    ~CacheMissCounter();
+
+    bool isAvailable() const;
+    void start();
+    unsigned long long stop();
+
+private:
+    CacheMissCounter(const CacheMissCounter&);
+    CacheMissCounter& operator=(const CacheMissCounter&);
+
+    int fd;
+};
+
 } //namespace cg3
 
 #include "system.tpp"
@@ -7,6 +7,17 @@
 
 #include "system.h"
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace cg3 {
 
 /**
@@ -78,4 +89,97 @@ inline bool executeCommand(const char* cmd, std::string& output)
     return rc == EXIT_SUCCESS;
 }
 
+/**
+ * @ingroup cg3core
+ * @brief returns the peak resident memory used by the process since its start
+ * @return the peak resident memory in bytes, or 0 if it is not available on the current system
+ */
+inline unsigned long long peakMemoryUsage()
+{
+    #ifdef _WIN32
+    return 0;
+    #else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    #ifdef __APPLE__
+    return (unsigned long long)usage.ru_maxrss; //bytes
+    #else
+    return (unsigned long long)usage.ru_maxrss * 1024; //kilobytes
+    #endif
+    #endif
+}
+
+/**
+ * @brief CacheMissCounter::CacheMissCounter
+ * Opens the hardware counter of the cache misses of the process (user space only).
+ * Use isAvailable() to check if the counter can be used.
+ */
+inline CacheMissCounter::CacheMissCounter() :
+    fd(-1)
+{
+    #ifdef __linux__
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    #endif
+}
+
+inline CacheMissCounter::~CacheMissCounter()
+{
+    #ifdef __linux__
+    if (fd >= 0)
+        close(fd);
+    #endif
+}
+
+/**
+ * @brief CacheMissCounter::isAvailable
+ * @return false if the performance counters are not supported or not accessible
+ * (e.g. because of /proc/sys/kernel/perf_event_paranoid)
+ */
+inline bool CacheMissCounter::isAvailable() const
+{
+    return fd >= 0;
+}
+
+/**
+ * @brief CacheMissCounter::start
+ * Resets the counter and starts counting.
+ */
+inline void CacheMissCounter::start()
+{
+    #ifdef __linux__
+    if (fd >= 0){
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    #endif
+}
+
+/**
+ * @brief CacheMissCounter::stop
+ * Stops counting.
+ * @return the cache misses counted since start(), or 0 if the counter is not available
+ */
+inline unsigned long long CacheMissCounter::stop()
+{
+    unsigned long long count = 0;
+    #ifdef __linux__
+    if (fd >= 0){
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count))
+            count = 0;
+    }
+    #endif
+    return count;
+}
+
 } //namespace cg3
@@ -0,0 +1,86 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_THREAD_POOL_H
+#define CG3_THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief The ThreadPool class is a simple work-stealing thread pool.
+ *
+ * Every worker thread has its own queue of tasks: a worker executes the tasks of its queue
+ * (the most recent first) and, when its queue is empty, steals the oldest task of the queue
+ * of another worker. Tasks submitted by a worker are pushed in its own queue, while tasks
+ * submitted by other threads are distributed among the queues in a round robin fashion.
+ *
+ * \code{.cpp}
+ * cg3::ThreadPool pool(8);
+ * std::vector<double> v(1000);
+ * pool.parallelFor(0, 1000, [&](unsigned int i){
+ *     v[i] = std::sqrt(i);
+ * });
+ * \endcode
+ *
+ * If a task throws an exception, the first exception is rethrown by wait().
+ */
+class ThreadPool
+{
+public:
+    ThreadPool(unsigned int nThreads = 0);
+    ~ThreadPool();
+
+    unsigned int numberThreads() const;
+    void submit(const std::function<void()>& task);
+    void wait();
+
+    template <class Function>
+    void parallelFor(unsigned int begin, unsigned int end, Function f);
+
+    static int currentThreadIndex();
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void workerLoop(unsigned int index);
+    bool popTask(unsigned int index, std::function<void()>& task);
+    static int& threadIndex();
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<TaskQueue> > queues;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allTasksDone;
+    std::atomic<unsigned int> queuedTasks;
+    unsigned int pendingTasks;
+    unsigned int nextQueue;
+    bool stop;
+    std::exception_ptr exception;
+};
+
+} //namespace cg3
+
+#include "thread_pool.tpp"
+
+#endif // CG3_THREAD_POOL_H
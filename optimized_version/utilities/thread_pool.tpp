@@ -0,0 +1,195 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace cg3 {
+
+/**
+ * @brief ThreadPool::ThreadPool
+ * Creates a thread pool and starts its worker threads.
+ * @param[in] nThreads: number of worker threads; if 0, the number of concurrent threads
+ * supported by the hardware is used.
+ */
+inline ThreadPool::ThreadPool(unsigned int nThreads) :
+    queuedTasks(0),
+    pendingTasks(0),
+    nextQueue(0),
+    stop(false)
+{
+    if (nThreads == 0)
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < nThreads; i++)
+        queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+    for (unsigned int i = 0; i < nThreads; i++)
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+/**
+ * @brief ThreadPool::~ThreadPool
+ * Executes all the remaining tasks and joins the worker threads.
+ */
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stop = true;
+    }
+    taskAvailable.notify_all();
+    for (std::thread& t : workers)
+        t.join();
+}
+
+/**
+ * @brief ThreadPool::numberThreads
+ * @return the number of worker threads of the pool
+ */
+inline unsigned int ThreadPool::numberThreads() const
+{
+    return (unsigned int)workers.size();
+}
+
+/**
+ * @brief ThreadPool::submit
+ * Adds a task to the pool. The task will be executed asynchronously by one of the workers.
+ * @param[in] task
+ */
+inline void ThreadPool::submit(const std::function<void()>& task)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned int q;
+    if (threadIndex() >= 0 && threadIndex() < (int)queues.size() &&
+            std::this_thread::get_id() == workers[threadIndex()].get_id())
+        q = threadIndex();
+    else
+        q = nextQueue++ % queues.size();
+    pendingTasks++;
+    {
+        std::unique_lock<std::mutex> queueLock(queues[q]->mutex);
+        queuedTasks++;
+        queues[q]->tasks.push_back(task);
+    }
+    lock.unlock();
+    taskAvailable.notify_one();
+}
+
+/**
+ * @brief ThreadPool::wait
+ * Waits until all the submitted tasks have been executed.
+ * It must not be called by a task of the pool.
+ * @throws the first exception thrown by a task, if any
+ */
+inline void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    allTasksDone.wait(lock, [this]{ return pendingTasks == 0; });
+    if (exception){
+        std::exception_ptr e = exception;
+        exception = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+/**
+ * @brief ThreadPool::parallelFor
+ * Calls f(i) for every i in [begin, end), distributing the calls among the workers, and waits
+ * until all the calls (and all the other tasks submitted to the pool) have been executed.
+ * The calls are grouped in chunks, which are stolen by idle workers.
+ * @param[in] begin
+ * @param[in] end
+ * @param[in] f: a callable object which takes an unsigned int
+ */
+template <class Function>
+void ThreadPool::parallelFor(unsigned int begin, unsigned int end, Function f)
+{
+    if (begin >= end)
+        return;
+    unsigned int grain = std::max(1u, (end - begin) / (8 * numberThreads()));
+    for (unsigned int first = begin; first < end; first += std::min(grain, end - first)){
+        unsigned int last = first + std::min(grain, end - first);
+        submit([first, last, &f](){
+            for (unsigned int i = first; i < last; i++)
+                f(i);
+        });
+    }
+    wait();
+}
+
+/**
+ * @brief ThreadPool::currentThreadIndex
+ * @return the index, in [0, numberThreads()), of the worker that is executing the calling
+ * task, or -1 if the caller is not a worker of a ThreadPool. It can be used to access
+ * per-thread data.
+ */
+inline int ThreadPool::currentThreadIndex()
+{
+    return threadIndex();
+}
+
+inline void ThreadPool::workerLoop(unsigned int index)
+{
+    threadIndex() = (int)index;
+    std::function<void()> task;
+    while (true){
+        if (popTask(index, task)){
+            try {
+                task();
+            }
+            catch(...){
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!exception)
+                    exception = std::current_exception();
+            }
+            task = nullptr;
+            std::unique_lock<std::mutex> lock(mutex);
+            if (--pendingTasks == 0)
+                allTasksDone.notify_all();
+        }
+        else {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]{ return stop || queuedTasks > 0; });
+            if (stop && queuedTasks == 0)
+                return;
+        }
+    }
+}
+
+/**
+ * @brief ThreadPool::popTask
+ * Takes the most recent task of the queue of the worker index or, if it is empty, steals
+ * the oldest task of the queue of another worker.
+ */
+inline bool ThreadPool::popTask(unsigned int index, std::function<void()>& task)
+{
+    for (unsigned int i = 0; i < queues.size(); i++){
+        TaskQueue& q = *queues[(index + i) % queues.size()];
+        std::unique_lock<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()){
+            if (i == 0){
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+            else {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline int& ThreadPool::threadIndex()
+{
+    static thread_local int index = -1;
+    return index;
+}
+
+} //namespace cg3